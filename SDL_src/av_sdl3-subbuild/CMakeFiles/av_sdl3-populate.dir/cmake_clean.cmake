@@ -0,0 +1,17 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/av_sdl3-populate"
+  "CMakeFiles/av_sdl3-populate-complete"
+  "av_sdl3-populate-prefix/src/av_sdl3-populate-stamp/av_sdl3-populate-build"
+  "av_sdl3-populate-prefix/src/av_sdl3-populate-stamp/av_sdl3-populate-configure"
+  "av_sdl3-populate-prefix/src/av_sdl3-populate-stamp/av_sdl3-populate-download"
+  "av_sdl3-populate-prefix/src/av_sdl3-populate-stamp/av_sdl3-populate-install"
+  "av_sdl3-populate-prefix/src/av_sdl3-populate-stamp/av_sdl3-populate-mkdir"
+  "av_sdl3-populate-prefix/src/av_sdl3-populate-stamp/av_sdl3-populate-patch"
+  "av_sdl3-populate-prefix/src/av_sdl3-populate-stamp/av_sdl3-populate-test"
+  "av_sdl3-populate-prefix/src/av_sdl3-populate-stamp/av_sdl3-populate-update"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang )
+  include(CMakeFiles/av_sdl3-populate.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
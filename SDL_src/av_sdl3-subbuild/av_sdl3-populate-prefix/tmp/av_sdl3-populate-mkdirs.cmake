@@ -0,0 +1,22 @@
+# Distributed under the OSI-approved BSD 3-Clause License.  See accompanying
+# file Copyright.txt or https://cmake.org/licensing for details.
+
+cmake_minimum_required(VERSION 3.5)
+
+file(MAKE_DIRECTORY
+  "/root/repo/SDL_src/av_sdl3-src"
+  "/root/repo/SDL_src/av_sdl3-build"
+  "/root/repo/SDL_src/av_sdl3-subbuild/av_sdl3-populate-prefix"
+  "/root/repo/SDL_src/av_sdl3-subbuild/av_sdl3-populate-prefix/tmp"
+  "/root/repo/SDL_src/av_sdl3-subbuild/av_sdl3-populate-prefix/src/av_sdl3-populate-stamp"
+  "/root/repo/SDL_src/av_sdl3-subbuild/av_sdl3-populate-prefix/src"
+  "/root/repo/SDL_src/av_sdl3-subbuild/av_sdl3-populate-prefix/src/av_sdl3-populate-stamp"
+)
+
+set(configSubDirs )
+foreach(subDir IN LISTS configSubDirs)
+    file(MAKE_DIRECTORY "/root/repo/SDL_src/av_sdl3-subbuild/av_sdl3-populate-prefix/src/av_sdl3-populate-stamp/${subDir}")
+endforeach()
+if(cfgdir)
+  file(MAKE_DIRECTORY "/root/repo/SDL_src/av_sdl3-subbuild/av_sdl3-populate-prefix/src/av_sdl3-populate-stamp${cfgdir}") # cfgdir has leading slash
+endif()
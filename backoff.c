@@ -0,0 +1,147 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2026 Davidson Francis <davidsondfgl@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <SDL3/SDL.h>
+
+#include "backoff.h"
+#include "refresh.h"
+#include "stats.h"
+#include "log.h"
+
+/*
+ * Failure policy
+ *
+ * A provider that fails (no network, bad json, timeout)
+ * is not run again at the next interval, but backed off
+ * exponentially: after the n-th failure in a row, the
+ * next update is delayed by interval * 2^(n-1), up to
+ * the maximum interval, with a random jitter (half of
+ * it), so many instances do not retry in lockstep.
+ *
+ * After max_failures in a row, the circuit opens: the
+ * provider is then only probed once per maximum interval
+ * (and only the first one, if hedged), until it answers
+ * again, which closes the circuit.
+ *
+ * All of this is only used by the worker thread, the
+ * delays are handed to the scheduler (refresh.c).
+ */
+static Uint32 base_ms;
+static Uint32 cap_ms;
+static int threshold;
+
+static int streak;
+static int open;
+
+/* Own random state: SDL_rand() is for the main thread. */
+static Uint64 rand_state;
+
+/**
+ * @brief Returns @p ms with a random 'equal jitter', i.e.,
+ * somewhere between @p ms / 2 and @p ms.
+ */
+static Uint32 jitter(Uint32 ms)
+{
+	Uint32 half;
+
+	half = SDL_min(ms / 2, SDL_MAX_SINT32 - 1);
+	return (ms - half + (Uint32)SDL_rand_r(&rand_state, (Sint32)half + 1));
+}
+
+/**
+ * @brief Initializes the failure policy.
+ *
+ * @param interval_ms  Regular update interval, the delay
+ *                     after the first failure.
+ * @param max_ms       Maximum delay, and the interval
+ *                     between probes while the circuit is
+ *                     open.
+ * @param max_failures Consecutive failures that open the
+ *                     circuit, 0 to never open it.
+ */
+void backoff_init(Uint32 interval_ms, Uint32 max_ms, int max_failures)
+{
+	base_ms    = interval_ms;
+	cap_ms     = max_ms < interval_ms ? interval_ms : max_ms;
+	threshold  = max_failures;
+	rand_state = SDL_GetPerformanceCounter();
+}
+
+/**
+ * @brief Accounts a failed update, and delays the next
+ * one accordingly.
+ */
+void backoff_failed(void)
+{
+	Uint64 ms;
+	int i;
+
+	streak++;
+	stats_inc(STATS_PROVIDER_FAILURES);
+	stats_set(STATS_PROVIDER_FAIL_STREAK, streak);
+
+	if (!open && threshold && streak >= threshold) {
+		open = 1;
+		stats_inc(STATS_BREAKER_TRIPS);
+		stats_set(STATS_BREAKER_OPEN, 1);
+		log_info("Provider failed %d times in a row, probing it every "
+			"%u s from now on\n", streak, cap_ms / 1000);
+	}
+
+	ms = base_ms;
+	for (i = 1; i < streak && ms < cap_ms; i++)
+		ms *= 2;
+	if (open || ms > cap_ms)
+		ms = cap_ms;
+
+	refresh_delay(jitter((Uint32)ms));
+}
+
+/**
+ * @brief Accounts a successful update, closing the
+ * circuit if open.
+ */
+void backoff_succeeded(void)
+{
+	if (!streak)
+		return;
+
+	if (open) {
+		log_info("Provider is back after %d failures\n", streak);
+		stats_set(STATS_BREAKER_OPEN, 0);
+	}
+
+	streak = 0;
+	open   = 0;
+	stats_set(STATS_PROVIDER_FAIL_STREAK, 0);
+}
+
+/**
+ * @brief Returns 1 if the circuit is open, i.e., the next
+ * update is just a probe, 0 otherwise.
+ */
+int backoff_open(void)
+{
+	return (open);
+}
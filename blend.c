@@ -0,0 +1,269 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2026 Davidson Francis <davidsondfgl@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <string.h>
+#include <SDL3/SDL.h>
+
+#include "blend.h"
+#include "log.h"
+
+#if (defined(__GNUC__) || defined(__clang__)) && \
+	(defined(__x86_64__) || defined(__i386__))
+#define BLEND_X86
+#include <immintrin.h>
+#endif
+
+/*
+ * CPU blending
+ *
+ * Used by the CPU compositor (i.e., when there is no GPU
+ * and SDL would use its software renderer anyway), blends
+ * premultiplied ARGB8888 pixels over each other ('over'
+ * operator):
+ *
+ *   dst = src + dst * (255 - src_alpha) / 255
+ *
+ * with SSE2 and AVX2 versions, chosen at runtime, and a
+ * scalar fallback.
+ */
+typedef void (*blend_row_fn)(Uint32 *dst, const Uint32 *src, int n);
+
+static blend_row_fn blend_row;
+static const char *blend_impl;
+
+/**
+ * @brief Blends a single pixel @p s over @p d.
+ */
+static inline Uint32 blend_pixel(Uint32 d, Uint32 s)
+{
+	Uint32 ia, rb, ag;
+
+	ia = 255 - (s >> 24);
+	if (ia == 0)
+		return (s);
+	if (ia == 255)
+		return (d);
+
+	/* Two channels at once, with x/255 ~= (x + 128 + (x + 128) / 256) / 256. */
+	rb  = (d & 0x00FF00FF) * ia + 0x00800080;
+	rb  = ((rb + ((rb >> 8) & 0x00FF00FF)) >> 8) & 0x00FF00FF;
+	ag  = ((d >> 8) & 0x00FF00FF) * ia + 0x00800080;
+	ag  = (ag + ((ag >> 8) & 0x00FF00FF)) & 0xFF00FF00;
+	return (s + (rb | ag));
+}
+
+/**
+ * @brief Blends @p n pixels of @p src over @p dst, scalar
+ * version.
+ */
+static void blend_row_scalar(Uint32 *dst, const Uint32 *src, int n)
+{
+	int i;
+	for (i = 0; i < n; i++)
+		dst[i] = blend_pixel(dst[i], src[i]);
+}
+
+#ifdef BLEND_X86
+
+/**
+ * @brief Blends @p n pixels of @p src over @p dst, SSE2
+ * version (4 pixels per iteration).
+ */
+__attribute__((target("sse2")))
+static void blend_row_sse2(Uint32 *dst, const Uint32 *src, int n)
+{
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i c255 = _mm_set1_epi16(255);
+	const __m128i c128 = _mm_set1_epi16(128);
+	__m128i s, d, slo, shi, dlo, dhi, alo, ahi;
+	int i;
+
+	for (i = 0; i + 4 <= n; i += 4) {
+		s = _mm_loadu_si128((const __m128i *)(src + i));
+
+		/* Fully transparent: nothing to do. */
+		if (_mm_movemask_epi8(_mm_cmpeq_epi32(s, zero)) == 0xFFFF)
+			continue;
+
+		d = _mm_loadu_si128((const __m128i *)(dst + i));
+
+		/* 255 - alpha, broadcast to all channels. */
+		slo = _mm_unpacklo_epi8(s, zero);
+		shi = _mm_unpackhi_epi8(s, zero);
+		alo = _mm_shufflehi_epi16(_mm_shufflelo_epi16(slo, 0xFF), 0xFF);
+		ahi = _mm_shufflehi_epi16(_mm_shufflelo_epi16(shi, 0xFF), 0xFF);
+		alo = _mm_sub_epi16(c255, alo);
+		ahi = _mm_sub_epi16(c255, ahi);
+
+		/* dst * (255 - alpha) / 255. */
+		dlo = _mm_add_epi16(_mm_mullo_epi16(_mm_unpacklo_epi8(d, zero), alo),
+			c128);
+		dhi = _mm_add_epi16(_mm_mullo_epi16(_mm_unpackhi_epi8(d, zero), ahi),
+			c128);
+		dlo = _mm_srli_epi16(_mm_add_epi16(dlo, _mm_srli_epi16(dlo, 8)), 8);
+		dhi = _mm_srli_epi16(_mm_add_epi16(dhi, _mm_srli_epi16(dhi, 8)), 8);
+
+		d = _mm_adds_epu8(s, _mm_packus_epi16(dlo, dhi));
+		_mm_storeu_si128((__m128i *)(dst + i), d);
+	}
+
+	blend_row_scalar(dst + i, src + i, n - i);
+}
+
+/**
+ * @brief Blends @p n pixels of @p src over @p dst, AVX2
+ * version (8 pixels per iteration).
+ */
+__attribute__((target("avx2")))
+static void blend_row_avx2(Uint32 *dst, const Uint32 *src, int n)
+{
+	const __m256i zero = _mm256_setzero_si256();
+	const __m256i c255 = _mm256_set1_epi16(255);
+	const __m256i c128 = _mm256_set1_epi16(128);
+	__m256i s, d, slo, shi, dlo, dhi, alo, ahi;
+	int i;
+
+	for (i = 0; i + 8 <= n; i += 8) {
+		s = _mm256_loadu_si256((const __m256i *)(src + i));
+
+		/* Fully transparent: nothing to do. */
+		if (_mm256_testz_si256(s, s))
+			continue;
+
+		d = _mm256_loadu_si256((const __m256i *)(dst + i));
+
+		/* 255 - alpha, broadcast to all channels. */
+		slo = _mm256_unpacklo_epi8(s, zero);
+		shi = _mm256_unpackhi_epi8(s, zero);
+		alo = _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(slo, 0xFF), 0xFF);
+		ahi = _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(shi, 0xFF), 0xFF);
+		alo = _mm256_sub_epi16(c255, alo);
+		ahi = _mm256_sub_epi16(c255, ahi);
+
+		/* dst * (255 - alpha) / 255. */
+		dlo = _mm256_add_epi16(
+			_mm256_mullo_epi16(_mm256_unpacklo_epi8(d, zero), alo), c128);
+		dhi = _mm256_add_epi16(
+			_mm256_mullo_epi16(_mm256_unpackhi_epi8(d, zero), ahi), c128);
+		dlo = _mm256_srli_epi16(
+			_mm256_add_epi16(dlo, _mm256_srli_epi16(dlo, 8)), 8);
+		dhi = _mm256_srli_epi16(
+			_mm256_add_epi16(dhi, _mm256_srli_epi16(dhi, 8)), 8);
+
+		/* Unpack/pack are both per 128-bit lane, so the
+		 * pixel order is kept. */
+		d = _mm256_adds_epu8(s, _mm256_packus_epi16(dlo, dhi));
+		_mm256_storeu_si256((__m256i *)(dst + i), d);
+	}
+
+	blend_row_sse2(dst + i, src + i, n - i);
+}
+
+#endif /* BLEND_X86 */
+
+/**
+ * @brief Selects the fastest blending routine available
+ * for the current CPU.
+ */
+void blend_init(void)
+{
+	blend_row  = blend_row_scalar;
+	blend_impl = "scalar";
+
+#ifdef BLEND_X86
+	if (SDL_HasAVX2()) {
+		blend_row  = blend_row_avx2;
+		blend_impl = "AVX2";
+	} else if (SDL_HasSSE2()) {
+		blend_row  = blend_row_sse2;
+		blend_impl = "SSE2";
+	}
+#endif
+}
+
+/**
+ * @brief Returns the name of the blending routine in use.
+ */
+const char *blend_name(void)
+{
+	return (blend_impl);
+}
+
+/**
+ * @brief Clears the area @p r of the surface @p dst to
+ * transparent.
+ *
+ * @param dst ARGB8888 surface.
+ * @param r   Area to be cleared, already within @p dst.
+ */
+void blend_clear(SDL_Surface *dst, const SDL_Rect *r)
+{
+	Uint8 *p;
+	int y;
+
+	p = (Uint8 *)dst->pixels + r->y * dst->pitch + r->x * 4;
+	for (y = 0; y < r->h; y++, p += dst->pitch)
+		memset(p, 0, r->w * 4);
+}
+
+/**
+ * @brief Blends the area @p sr of the surface @p src over
+ * the surface @p dst, at coordinates @p x and @p y,
+ * restricted to the area @p clip of @p dst.
+ *
+ * Both surfaces must be premultiplied ARGB8888 (or XRGB8888,
+ * for @p dst).
+ *
+ * @param dst  Destination surface.
+ * @param x    Destination X coordinate.
+ * @param y    Destination Y coordinate.
+ * @param src  Source surface.
+ * @param sr   Source area.
+ * @param clip Destination clip area, already within @p dst.
+ */
+void blend_over(SDL_Surface *dst, int x, int y,
+	const SDL_Surface *src, const SDL_Rect *sr, const SDL_Rect *clip)
+{
+	const Uint8 *s;
+	Uint8 *d;
+	SDL_Rect dr, r;
+	int row;
+
+	dr.x = x;
+	dr.y = y;
+	dr.w = sr->w;
+	dr.h = sr->h;
+	if (!SDL_GetRectIntersection(&dr, clip, &r))
+		return;
+
+	s = (const Uint8 *)src->pixels + (sr->y + r.y - y) * src->pitch +
+		(sr->x + r.x - x) * 4;
+	d = (Uint8 *)dst->pixels + r.y * dst->pitch + r.x * 4;
+
+	for (row = 0; row < r.h; row++) {
+		blend_row((Uint32 *)d, (const Uint32 *)s, r.w);
+		s += src->pitch;
+		d += dst->pitch;
+	}
+}
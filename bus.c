@@ -0,0 +1,432 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2026 Davidson Francis <davidsondfgl@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <linux/futex.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+#include <SDL3/SDL.h>
+
+#include "bus.h"
+#include "stats.h"
+#include "worker.h"
+#include "log.h"
+
+/*
+ * Shared segment layout.
+ *
+ * 'seq' is a seqlock: odd while the leader writes 'wi',
+ * so readers copy 'wi' lock-free and retry if 'seq'
+ * changed meanwhile. It is also a futex, so that the
+ * other instances sleep until something is published,
+ * without polling.
+ *
+ * 'beat' is the (wall clock) time of the last update
+ * done by the leader, successful or not, and 'period'
+ * the longest it might take between two of them: a
+ * leader that misses it for too long is considered
+ * stuck. A leader that gives the lead up clears 'beat'.
+ */
+struct bus_segment
+{
+	Uint32 magic;
+	Uint32 size;   /* sizeof(struct weather_info). */
+	SDL_AtomicInt seq;
+	Sint32 leader; /* Leader pid, informative only. */
+	SDL_AtomicU32 beat;
+	SDL_AtomicU32 period;
+	struct weather_info wi;
+};
+
+/* Seqlock read attempts, before giving up. */
+#define BUS_READ_TRIES 64
+
+/* Extra time, in seconds, before a leader is considered stuck. */
+#define BUS_GRACE_SECS 60
+
+static struct bus_segment *seg;
+static int bus_fd = -1;
+static SDL_AtomicInt leading;
+static SDL_AtomicInt stop;
+static SDL_Thread *thread;
+static Uint32 period_secs;
+
+/* The leader seems stuck, fetch by ourselves. */
+static SDL_AtomicInt orphan;
+
+/**
+ * @brief Waits until the futex @p addr no longer holds
+ * @p val (or a wake up), for up to @p secs seconds.
+ */
+static void futex_wait(SDL_AtomicInt *addr, int val, Uint32 secs)
+{
+	struct timespec ts = {.tv_sec = secs, .tv_nsec = 0};
+	syscall(SYS_futex, &addr->value, FUTEX_WAIT, val, &ts, NULL, 0);
+}
+
+/**
+ * @brief Wakes up everyone waiting on the futex @p addr,
+ * in any process.
+ */
+static void futex_wake(SDL_AtomicInt *addr)
+{
+	syscall(SYS_futex, &addr->value, FUTEX_WAKE, INT_MAX, NULL, NULL, 0);
+}
+
+/**
+ * @brief Reads the weather info published, if any.
+ *
+ * @param wi  Weather info read.
+ * @param seq Seqlock value it was read at.
+ *
+ * @return Returns 0 if success, -1 if nothing (valid)
+ * could be read.
+ */
+static int bus_read(struct weather_info *wi, int *seq)
+{
+	int s1, s2;
+	int i;
+
+	for (i = 0; i < BUS_READ_TRIES; i++) {
+		s1 = SDL_GetAtomicInt(&seg->seq);
+		if (!s1 || (s1 & 1))
+			return (-1);
+
+		SDL_MemoryBarrierAcquire();
+		memcpy(wi, &seg->wi, sizeof(*wi));
+		SDL_MemoryBarrierAcquire();
+
+		s2 = SDL_GetAtomicInt(&seg->seq);
+		if (s1 == s2) {
+			*seq = s1;
+			/* Written by another process, trust nothing. */
+			return (weather_check(wi));
+		}
+	}
+	return (-1);
+}
+
+/**
+ * @brief Returns the current wall clock time, in seconds.
+ */
+static Uint32 now_secs(void)
+{
+	return ((Uint32)time(NULL));
+}
+
+/**
+ * @brief Checks what the leader is up to, while not
+ * leading: if it gave the lead up, or seems stuck, an
+ * update is requested right away, instead of waiting
+ * for the next scheduled one.
+ *
+ * @param last_beat Last leader beat seen, updated.
+ *
+ * @return Returns how long to wait (in seconds) before
+ * checking again, if nothing is published meanwhile.
+ */
+static Uint32 check_leader(Uint32 *last_beat)
+{
+	Uint32 beat, period, now, deadline;
+
+	beat   = SDL_GetAtomicU32(&seg->beat);
+	period = SDL_GetAtomicU32(&seg->period);
+
+	/* Gave the lead up: anyone may take it. */
+	if (!beat) {
+		if (*last_beat) {
+			log_info("Weather bus leader is gone, taking over...\n");
+			worker_request_update();
+		}
+		*last_beat = 0;
+		return (period_secs);
+	}
+	*last_beat = beat;
+
+	now      = now_secs();
+	deadline = beat + 2 * SDL_max(period, period_secs) + BUS_GRACE_SECS;
+	if (now < deadline)
+		return (deadline - now);
+
+	if (!SDL_GetAtomicInt(&orphan)) {
+		log_info("Weather bus leader %d seems stuck, fetching by "
+			"ourselves\n", (int)seg->leader);
+		SDL_SetAtomicInt(&orphan, 1);
+		worker_request_update();
+	}
+	return (period_secs);
+}
+
+/**
+ * @brief Bus thread: waits for new weather info published
+ * by the leader and shows it, while not leading.
+ *
+ * @param data Unused.
+ *
+ * @return Always 0.
+ */
+static int bus_thread(void *data)
+{
+	struct weather_info wi;
+	int seen, seq, cur;
+	Uint32 last_beat;
+	Uint32 wait;
+
+	((void)data);
+
+	seen      = 0;
+	last_beat = 0;
+	while (!SDL_GetAtomicInt(&stop))
+	{
+		cur = SDL_GetAtomicInt(&seg->seq);
+
+		if (cur != seen && !(cur & 1) && !SDL_GetAtomicInt(&leading) &&
+			!bus_read(&wi, &seq))
+		{
+			log_info("Weather info published by instance %d\n",
+				(int)seg->leader);
+			stats_inc(STATS_UPDATES_SHARED);
+			SDL_SetAtomicInt(&orphan, 0);
+			worker_push(&wi);
+			seen = seq;
+			continue;
+		}
+
+		seen = cur;
+		wait = period_secs;
+		if (!SDL_GetAtomicInt(&leading))
+			wait = SDL_max(check_leader(&last_beat), 1);
+		futex_wait(&seg->seq, cur, wait);
+	}
+
+	SDL_SetAtomicInt(&stop, 2);
+	return (0);
+}
+
+/**
+ * @brief Opens (or creates) the bus for the provider
+ * identified by @p key.
+ *
+ * The bus is optional: if anything fails, this instance
+ * just fetches the weather by itself.
+ *
+ * @param key       Provider identification, e.g., its
+ *                  command.
+ * @param period_ms Longest time between two updates of
+ *                  this instance, e.g., its maximum
+ *                  update interval.
+ *
+ * @return Returns 0 if success, -1 otherwise.
+ */
+int bus_open(const char *key, Uint32 period_ms)
+{
+	char name[48];
+	uint64_t h;
+	struct stat st;
+
+	/* 64-bit FNV-1a of the key. */
+	for (h = 0xcbf29ce484222325ULL; *key; key++)
+		h = (h ^ (unsigned char)*key) * 0x100000001b3ULL;
+
+	/* Per user: nobody else can lead or write it. */
+	snprintf(name, sizeof(name), "/windy-%u-%016llx", (unsigned)geteuid(),
+		(unsigned long long)h);
+
+	bus_fd = shm_open(name, O_RDWR|O_CREAT|O_CLOEXEC, 0600);
+	if (bus_fd < 0)
+		log_err_to(out0, "Unable to open weather bus %s: %s\n", name,
+			strerror(errno));
+
+	if (fstat(bus_fd, &st) < 0)
+		log_err_to(out1, "Unable to stat weather bus: %s\n", strerror(errno));
+
+	/* Created beforehand by someone else? */
+	if (st.st_uid != geteuid() || (st.st_mode & 077))
+		log_err_to(out1, "Weather bus %s is not private, ignoring it!\n",
+			name);
+	if (st.st_size < (off_t)sizeof(*seg) &&
+		ftruncate(bus_fd, sizeof(*seg)) < 0)
+	{
+		log_err_to(out1, "Unable to size weather bus: %s\n", strerror(errno));
+	}
+
+	seg = mmap(NULL, sizeof(*seg), PROT_READ|PROT_WRITE, MAP_SHARED,
+		bus_fd, 0);
+	if (seg == MAP_FAILED)
+		log_err_to(out1, "Unable to map weather bus: %s\n", strerror(errno));
+
+	/* Fresh segment (zero-filled): everyone writes the same. */
+	if (!seg->magic) {
+		seg->size  = sizeof(struct weather_info);
+		seg->magic = BUS_MAGIC;
+	}
+	if (seg->magic != BUS_MAGIC || seg->size != sizeof(struct weather_info))
+		log_err_to(out2, "Weather bus %s has an incompatible layout!\n",
+			name);
+
+	period_secs = SDL_max(period_ms / 1000, 1);
+
+	log_info("Sharing the weather through the bus %s\n", name);
+	return (0);
+out2:
+	munmap(seg, sizeof(*seg));
+out1:
+	close(bus_fd);
+out0:
+	seg    = NULL;
+	bus_fd = -1;
+	return (-1);
+}
+
+/**
+ * @brief Starts following the bus, i.e., showing what
+ * the leader publishes (see worker_push()), including
+ * what was already published, if any.
+ */
+void bus_follow(void)
+{
+	if (!seg)
+		return;
+
+	thread = SDL_CreateThread(bus_thread, "windy-bus", NULL);
+	if (!thread)
+		log_panic("Unable to create bus thread: %s\n", SDL_GetError());
+}
+
+/**
+ * @brief Checks if this instance should fetch the weather
+ * by itself, i.e., if it leads the bus (taking the lead,
+ * if nobody else has it), if the leader seems stuck, or
+ * if there is no bus at all.
+ *
+ * Meant to be called for each update: while leading,
+ * this also tells the others that the leader is alive.
+ *
+ * @return Returns 1 if so, 0 if another instance fetches
+ * the weather for us.
+ */
+int bus_lead(void)
+{
+	if (!seg)
+		return (1);
+
+	if (!SDL_GetAtomicInt(&leading)) {
+		if (flock(bus_fd, LOCK_EX|LOCK_NB) < 0)
+			return (SDL_GetAtomicInt(&orphan));
+
+		SDL_SetAtomicInt(&leading, 1);
+		SDL_SetAtomicInt(&orphan, 0);
+		seg->leader = (Sint32)getpid();
+		SDL_SetAtomicU32(&seg->period, period_secs);
+		log_info("Leading the weather bus, fetching for all instances\n");
+	}
+
+	SDL_SetAtomicU32(&seg->beat, now_secs());
+	return (1);
+}
+
+/**
+ * @brief Gives the lead up (e.g., the window is hidden,
+ * and fetches are deferred), so another instance can
+ * take it over.
+ */
+void bus_resign(void)
+{
+	if (!seg || !SDL_GetAtomicInt(&leading))
+		return;
+
+	SDL_SetAtomicInt(&leading, 0);
+	SDL_SetAtomicU32(&seg->beat, 0);
+	flock(bus_fd, LOCK_UN);
+	futex_wake(&seg->seq);
+	log_info("Weather bus lead released\n");
+}
+
+/**
+ * @brief Publishes the weather info @p wi to all the
+ * other instances, if leading the bus.
+ *
+ * @param wi Weather info.
+ */
+void bus_publish(const struct weather_info *wi)
+{
+	int s;
+
+	if (!seg || !SDL_GetAtomicInt(&leading))
+		return;
+
+	/*
+	 * An odd value here means that a previous leader died
+	 * while writing (we hold the lock), so just move on.
+	 */
+	s = SDL_GetAtomicInt(&seg->seq);
+	s = (s + 1) | 1;
+
+	SDL_SetAtomicInt(&seg->seq, s);
+	SDL_MemoryBarrierRelease();
+	memcpy(&seg->wi, wi, sizeof(*wi));
+	SDL_MemoryBarrierRelease();
+	SDL_SetAtomicInt(&seg->seq, s + 1);
+
+	futex_wake(&seg->seq);
+}
+
+/**
+ * @brief Stops following the bus, and gives the lead up,
+ * if leading.
+ *
+ * The segment itself is kept, for the other instances
+ * (and the next ones).
+ */
+void bus_close(void)
+{
+	if (!seg)
+		return;
+
+	/* The thread might miss a single wake up, not all. */
+	if (thread) {
+		SDL_SetAtomicInt(&stop, 1);
+		while (SDL_GetAtomicInt(&stop) == 1) {
+			futex_wake(&seg->seq);
+			SDL_Delay(1);
+		}
+		SDL_WaitThread(thread, NULL);
+		thread = NULL;
+	}
+
+	bus_resign();
+	munmap(seg, sizeof(*seg));
+	close(bus_fd);
+	seg    = NULL;
+	bus_fd = -1;
+}
@@ -0,0 +1,56 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2026 Davidson Francis <davidsondfgl@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef BUS_H
+#define BUS_H
+
+	#include <SDL3/SDL.h>
+	#include "weather.h"
+
+	/*
+	 * Weather bus (-b)
+	 *
+	 * Instances of the same user with the same provider
+	 * (e.g., one per screen, for the same city) share a
+	 * single fetch, through a private shared memory segment
+	 * named after the user and the provider: the instance
+	 * holding its lock (the leader) runs the provider and
+	 * publishes the weather info, and all the others just
+	 * show what is published.
+	 *
+	 * If the leader gives the lead up (exits, or its window
+	 * is hidden), another instance takes over right away.
+	 * If it stops updating for too long (e.g., it crashed
+	 * or hangs), the others fetch by themselves meanwhile.
+	 */
+	#define BUS_MAGIC 0x59444e57 /* 'WNDY'. */
+
+	extern int  bus_open(const char *key, Uint32 period_ms);
+	extern void bus_follow(void);
+	extern int  bus_lead(void);
+	extern void bus_resign(void);
+	extern void bus_publish(const struct weather_info *wi);
+	extern void bus_close(void);
+
+#endif /* BUS_H */
@@ -0,0 +1,380 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2026 Davidson Francis <davidsondfgl@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#define _GNU_SOURCE /* accept4(). */
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <poll.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <SDL3/SDL.h>
+
+#include "control.h"
+#include "stats.h"
+#include "weather.h"
+#include "worker.h"
+#include "log.h"
+
+/*
+ * Control socket, see control.h.
+ *
+ * A single thread serves all clients, with poll(): messages
+ * are small and cheap to handle, and a client that never
+ * finishes its line does not hold the others.
+ */
+struct client
+{
+	int fd;
+	size_t len;
+	char *buf; /* CONTROL_MAX_MESSAGE bytes. */
+};
+
+static SDL_Thread *thread;
+static char sock_path[PATH_MAX];
+static int listen_fd = -1;
+static int wake_fds[2] = {-1, -1};
+static struct client clients[CONTROL_MAX_CLIENTS];
+
+/**
+ * @brief Sends the reply @p msg to the client @p c.
+ *
+ * Clients are non-blocking: a client that does not read
+ * its replies just misses them.
+ *
+ * @param c   Client.
+ * @param msg Reply, NUL-terminated.
+ */
+static void reply(const struct client *c, const char *msg)
+{
+	send(c->fd, msg, strlen(msg), MSG_NOSIGNAL);
+}
+
+/**
+ * @brief Handles a single message @p msg, of length
+ * @p len, from the client @p c.
+ *
+ * @param c   Client.
+ * @param msg Message, NUL-terminated, without newline.
+ * @param len Message length.
+ */
+static void handle_message(const struct client *c, char *msg, size_t len)
+{
+	char stats[STATS_TEXT_SIZE + 4];
+	struct weather_info wi;
+	size_t n;
+
+	if (len && msg[len - 1] == '\r')
+		msg[--len] = '\0';
+	if (!len)
+		return;
+
+	/* Weather json, same checks as the provider output. */
+	if (msg[0] == '{') {
+		switch (weather_parse(msg, len, &wi)) {
+		case 0:
+			stats_inc(STATS_UPDATES_PUSHED);
+			worker_push(&wi);
+			reply(c, "ok\n");
+			break;
+		case 1:
+			/* {"unchanged":true}: nothing to do. */
+			reply(c, "ok\n");
+			break;
+		default:
+			reply(c, "error: invalid weather json\n");
+			break;
+		}
+	}
+
+	else if (!strcmp(msg, "refresh")) {
+		if (worker_request_update() < 0)
+			reply(c, "error: no provider to refresh from\n");
+		else
+			reply(c, "ok\n");
+	}
+
+	else if (!strcmp(msg, "stats")) {
+		n = stats_format(stats, STATS_TEXT_SIZE);
+		memcpy(stats + n, "ok\n", 4);
+		reply(c, stats);
+	}
+
+	else
+		reply(c, "error: unknown command\n");
+}
+
+/**
+ * @brief Closes the connection with the client @p c.
+ *
+ * @param c Client.
+ */
+static void client_close(struct client *c)
+{
+	close(c->fd);
+	free(c->buf);
+	c->fd  = -1;
+	c->buf = NULL;
+	c->len = 0;
+}
+
+/**
+ * @brief Reads whatever the client @p c sent and handles
+ * all complete messages.
+ *
+ * A last message without newline is handled once the
+ * client closes its side, e.g.:
+ *   $ printf refresh | nc -UN /path/to/socket
+ *
+ * @param c Client.
+ */
+static void client_read(struct client *c)
+{
+	char *start, *nl;
+	size_t left;
+	ssize_t r;
+
+	r = read(c->fd, c->buf + c->len, CONTROL_MAX_MESSAGE - 1 - c->len);
+	if (r < 0 && (errno == EAGAIN || errno == EINTR))
+		return;
+
+	if (r <= 0) {
+		if (r == 0 && c->len) {
+			c->buf[c->len] = '\0';
+			handle_message(c, c->buf, c->len);
+		}
+		client_close(c);
+		return;
+	}
+
+	c->len += r;
+	start   = c->buf;
+	left    = c->len;
+
+	while ((nl = memchr(start, '\n', left))) {
+		*nl = '\0';
+		handle_message(c, start, nl - start);
+		left -= nl - start + 1;
+		start = nl + 1;
+	}
+
+	memmove(c->buf, start, left);
+	c->len = left;
+
+	if (c->len == CONTROL_MAX_MESSAGE - 1) {
+		reply(c, "error: message too long\n");
+		client_close(c);
+	}
+}
+
+/**
+ * @brief Accepts a new client, if there is room for it.
+ */
+static void client_accept(void)
+{
+	int fd;
+	int i;
+
+	fd = accept4(listen_fd, NULL, NULL, SOCK_NONBLOCK|SOCK_CLOEXEC);
+	if (fd < 0)
+		return;
+
+	for (i = 0; i < CONTROL_MAX_CLIENTS; i++) {
+		if (clients[i].fd >= 0)
+			continue;
+
+		if (!(clients[i].buf = malloc(CONTROL_MAX_MESSAGE)))
+			break;
+
+		clients[i].fd  = fd;
+		clients[i].len = 0;
+		return;
+	}
+
+	send(fd, "error: too many clients\n", 24, MSG_NOSIGNAL);
+	close(fd);
+}
+
+/**
+ * @brief Control thread: serves the listening socket and
+ * all clients, until woken up by control_stop().
+ *
+ * @param data Unused.
+ *
+ * @return Always 0.
+ */
+static int control_thread(void *data)
+{
+	struct pollfd pfds[2 + CONTROL_MAX_CLIENTS];
+	int idx[2 + CONTROL_MAX_CLIENTS];
+	int nfds;
+	int i;
+
+	((void)data);
+
+	while (1)
+	{
+		pfds[0].fd     = wake_fds[0];
+		pfds[0].events = POLLIN;
+		pfds[1].fd     = listen_fd;
+		pfds[1].events = POLLIN;
+		nfds = 2;
+
+		for (i = 0; i < CONTROL_MAX_CLIENTS; i++) {
+			if (clients[i].fd < 0)
+				continue;
+			pfds[nfds].fd     = clients[i].fd;
+			pfds[nfds].events = POLLIN;
+			idx[nfds++]       = i;
+		}
+
+		if (poll(pfds, nfds, -1) < 0) {
+			if (errno == EINTR)
+				continue;
+			log_err_to(out, "Control socket poll failed: %s\n",
+				strerror(errno));
+		}
+
+		if (pfds[0].revents)
+			break;
+
+		for (i = 2; i < nfds; i++)
+			if (pfds[i].revents)
+				client_read(&clients[idx[i]]);
+
+		if (pfds[1].revents & POLLIN)
+			client_accept();
+	}
+
+out:
+	for (i = 0; i < CONTROL_MAX_CLIENTS; i++)
+		if (clients[i].fd >= 0)
+			client_close(&clients[i]);
+	return (0);
+}
+
+/**
+ * @brief Creates the control socket at @p path.
+ *
+ * Relative paths are relative to the current directory,
+ * so this must be called before changing it. A stale
+ * socket left at @p path (i.e., nobody listening) is
+ * replaced, but a live one is a fatal error.
+ *
+ * @param path Socket path.
+ */
+void control_open(const char *path)
+{
+	struct sockaddr_un addr;
+	struct stat st;
+	int fd;
+
+	memset(&addr, 0, sizeof(addr));
+	addr.sun_family = AF_UNIX;
+	if (strlen(path) >= sizeof(addr.sun_path))
+		log_panic("Control socket path too long: %s\n", path);
+	strcpy(addr.sun_path, path);
+
+	/* Absolute, to be removed after leaving this directory. */
+	if (path[0] == '/')
+		snprintf(sock_path, sizeof(sock_path), "%s", path);
+	else if (!getcwd(sock_path, sizeof(sock_path)) ||
+		strlen(sock_path) + strlen(path) + 2 > sizeof(sock_path))
+	{
+		log_panic("Unable to resolve control socket path: %s\n", path);
+	}
+	else {
+		strcat(sock_path, "/");
+		strcat(sock_path, path);
+	}
+
+	listen_fd = socket(AF_UNIX, SOCK_STREAM|SOCK_CLOEXEC, 0);
+	if (listen_fd < 0)
+		log_panic("Unable to create control socket: %s\n", strerror(errno));
+
+	/* Already in use? */
+	if (!lstat(path, &st) && S_ISSOCK(st.st_mode)) {
+		fd = socket(AF_UNIX, SOCK_STREAM|SOCK_CLOEXEC, 0);
+		if (fd >= 0 && !connect(fd, (struct sockaddr *)&addr, sizeof(addr)))
+			log_panic("Control socket %s is in use by another instance!\n",
+				path);
+		if (fd >= 0)
+			close(fd);
+		unlink(path);
+	}
+
+	/* Clients might connect already, and wait for control_start(). */
+	if (bind(listen_fd, (struct sockaddr *)&addr, sizeof(addr)) < 0 ||
+		listen(listen_fd, CONTROL_MAX_CLIENTS) < 0)
+	{
+		log_panic("Unable to listen at %s: %s\n", path, strerror(errno));
+	}
+}
+
+/**
+ * @brief Starts serving the control socket opened by
+ * control_open(), if any.
+ */
+void control_start(void)
+{
+	int i;
+
+	if (listen_fd < 0)
+		return;
+
+	if (pipe2(wake_fds, O_CLOEXEC) < 0)
+		log_panic("Unable to create control pipe: %s\n", strerror(errno));
+
+	for (i = 0; i < CONTROL_MAX_CLIENTS; i++)
+		clients[i].fd = -1;
+
+	thread = SDL_CreateThread(control_thread, "windy-control", NULL);
+	if (!thread)
+		log_panic("Unable to create control thread: %s\n", SDL_GetError());
+
+	log_info("Listening for control messages at %s\n", sock_path);
+}
+
+/**
+ * @brief Stops serving the control socket and removes it.
+ */
+void control_stop(void)
+{
+	if (!thread)
+		return;
+
+	write(wake_fds[1], "", 1);
+	SDL_WaitThread(thread, NULL);
+	thread = NULL;
+
+	close(wake_fds[0]);
+	close(wake_fds[1]);
+	close(listen_fd);
+	unlink(sock_path);
+}
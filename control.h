@@ -0,0 +1,51 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2026 Davidson Francis <davidsondfgl@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef CONTROL_H
+#define CONTROL_H
+
+	/*
+	 * Control socket (-s)
+	 *
+	 * A Unix domain (stream) socket that accepts newline-
+	 * delimited messages, one per line:
+	 *
+	 * - A weather json (i.e., a line starting with '{'),
+	 *   exactly as a provider would output it, and that
+	 *   is validated the same way: shown right away, no
+	 *   polling or provider needed.
+	 * - 'refresh': runs the provider now.
+	 * - 'stats':   dumps the internal counters.
+	 *
+	 * Each message gets a single line reply, 'ok' or
+	 * 'error: <reason>' (after the counters, for 'stats').
+	 */
+	#define CONTROL_MAX_CLIENTS   8
+	#define CONTROL_MAX_MESSAGE   (64 * 1024)
+
+	extern void control_open(const char *path);
+	extern void control_start(void);
+	extern void control_stop(void);
+
+#endif /* CONTROL_H */
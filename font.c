@@ -133,10 +133,13 @@ void font_close(TTF_Font *font) {
 }
 
 /**
- * @brief Creates a new SDL_Texture for a given @p text,
- * @p color and @p font, returning the result into @p rt.
+ * @brief Rasterizes a given @p text, with @p color and
+ * @p font into a new SDL_Surface.
+ *
+ * Since this does not touch the renderer, it is safe to
+ * be called from any thread, as long as the font is not
+ * shared between threads.
  *
- * @param rt     Rendered text structure pointer.
  * @param font   Already opened TTF font.
  * @param text   Text to be created.
  * @param color  SDL color
@@ -144,12 +147,10 @@ void font_close(TTF_Font *font) {
  *               check). If the text exceeds the maximum
  *               size, ellipsis will be added.
  *
- * @note If there is an previous allocated text, it will
- * be destroyed first, so multiples calls to this is
- * safe.
+ * @return Returns the rasterized text surface.
  */
-void font_create_text(struct rendered_text *rt, TTF_Font *font,
-	const char *text, const SDL_Color *color, unsigned mwidth)
+SDL_Surface *font_create_surface(TTF_Font *font, const char *text,
+	const SDL_Color *color, unsigned mwidth)
 {
 	SDL_Surface *s;
 	char *new_text;
@@ -157,12 +158,6 @@ void font_create_text(struct rendered_text *rt, TTF_Font *font,
 
 	new_text = NULL;
 
-	if (!rt)
-		return;
-
-	/* Clear previous text, if any. */
-	font_destroy_text(rt);
-
 	/*
 	 * Check maximum width was provided _and_ if the
 	 * the text exceeds the maximum size.
@@ -178,19 +173,71 @@ void font_create_text(struct rendered_text *rt, TTF_Font *font,
 		}
 	}
 
-	/* Create a new one. */
 	s = TTF_RenderText_Blended(font, text, 0, *color);
 	if (!s)
 		log_panic("Unable to create font surface!\n");
 
+	free(new_text);
+	return (s);
+}
+
+/**
+ * @brief Uploads a previously rasterized text surface
+ * @p s into the rendered text @p rt.
+ *
+ * The surface is not freed, and must be called from
+ * the same thread that owns the renderer.
+ *
+ * @param rt Rendered text structure pointer.
+ * @param s  Text surface, as returned by font_create_surface().
+ *
+ * @note If there is an previous allocated text, it will
+ * be destroyed first, so multiples calls to this is
+ * safe.
+ */
+void font_upload_text(struct rendered_text *rt, SDL_Surface *s)
+{
+	if (!rt)
+		return;
+
+	/* Clear previous text, if any. */
+	font_destroy_text(rt);
+
 	rt->text_texture = SDL_CreateTextureFromSurface(renderer, s);
 	if (!rt->text_texture)
 		log_panic("Unable to create font texture!\n");
 
 	rt->width  = s->w;
 	rt->height = s->h;
+}
+
+/**
+ * @brief Creates a new SDL_Texture for a given @p text,
+ * @p color and @p font, returning the result into @p rt.
+ *
+ * @param rt     Rendered text structure pointer.
+ * @param font   Already opened TTF font.
+ * @param text   Text to be created.
+ * @param color  SDL color
+ * @param mwidth Maximum text width (in pixels, 0 to not
+ *               check). If the text exceeds the maximum
+ *               size, ellipsis will be added.
+ *
+ * @note If there is an previous allocated text, it will
+ * be destroyed first, so multiples calls to this is
+ * safe.
+ */
+void font_create_text(struct rendered_text *rt, TTF_Font *font,
+	const char *text, const SDL_Color *color, unsigned mwidth)
+{
+	SDL_Surface *s;
+
+	if (!rt)
+		return;
+
+	s = font_create_surface(font, text, color, mwidth);
+	font_upload_text(rt, s);
 	SDL_DestroySurface(s);
-	free(new_text);
 }
 
 /**
@@ -38,6 +38,10 @@
 	extern void font_quit(void);
 	extern TTF_Font *font_open(const char *file, int ptsize);
 	extern void font_close(TTF_Font *font);
+	extern SDL_Surface *font_create_surface(TTF_Font *font,
+		const char *text, const SDL_Color *color, unsigned mwidth);
+	extern void font_upload_text(struct rendered_text *rt,
+		SDL_Surface *s);
 	extern void font_create_text(struct rendered_text *rt, TTF_Font *font,
 		const char *text, const SDL_Color *color, unsigned mwidth);
 	extern void font_destroy_text(struct rendered_text *rt);
@@ -0,0 +1,355 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2026 Davidson Francis <davidsondfgl@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <string.h>
+#include <SDL3/SDL.h>
+
+#include "glyph.h"
+#include "image.h"
+#include "log.h"
+
+/*
+ * Glyph atlas
+ *
+ * Most texts on screen are temperatures, i.e., made of
+ * digits, '-' and 'º' only. Instead of rasterizing them
+ * on every update, each of these glyphs is rasterized
+ * only once per (font, color) pair, uploaded into the
+ * atlas glyph region, and numeric texts are then laid
+ * out as glyph runs, by using the cached advances and
+ * kerning.
+ *
+ * Glyph sets are created (rasterized) by the worker
+ * thread and uploaded by the main thread, on the next
+ * commit.
+ */
+#define GLYPH_SETS 8
+
+static const Uint32 charset[] = {
+	'0', '1', '2', '3', '4', '5', '6', '7', '8', '9',
+	'-', ' ', 0xBA /* º */
+};
+#define GLYPH_COUNT ((int)(sizeof(charset) / sizeof(charset[0])))
+
+static struct glyph_set
+{
+	TTF_Font *font;
+	SDL_Color color;
+	int advance[GLYPH_COUNT];
+	int left[GLYPH_COUNT];   /* Leftmost pixel, from the pen.  */
+	int right[GLYPH_COUNT];  /* Rightmost pixel, from the pen. */
+	int height;
+	int kern[GLYPH_COUNT][GLYPH_COUNT];
+	SDL_Surface *pending[GLYPH_COUNT];
+	struct image img[GLYPH_COUNT];
+	int uploaded;
+} sets[GLYPH_SETS];
+
+static int nsets;
+static SDL_Mutex *lock;
+
+/**
+ * @brief Decodes the next UTF-8 codepoint of @p s.
+ *
+ * @param s String pointer, advanced to the next codepoint.
+ *
+ * @return Returns the codepoint, or 0 if invalid (or
+ * the end of the string).
+ */
+static Uint32 utf8_next(const unsigned char **s)
+{
+	const unsigned char *p;
+	Uint32 c;
+
+	p = *s;
+	if (p[0] < 0x80)
+		c = *p++;
+	else if ((p[0] & 0xE0) == 0xC0 && (p[1] & 0xC0) == 0x80) {
+		c  = ((p[0] & 0x1F) << 6) | (p[1] & 0x3F);
+		p += 2;
+	} else
+		c = 0;
+
+	*s = p;
+	return (c);
+}
+
+/**
+ * @brief Returns the glyph index of the codepoint @p c,
+ * or -1 if not in the charset.
+ */
+static int glyph_index(Uint32 c)
+{
+	int i;
+	for (i = 0; i < GLYPH_COUNT; i++)
+		if (charset[i] == c)
+			return (i);
+	return (-1);
+}
+
+/**
+ * @brief Rasterizes all glyphs of the set @p gs and
+ * caches their metrics.
+ *
+ * @param gs Glyph set, with font and color set.
+ *
+ * @return Returns 0 if success, -1 otherwise.
+ */
+static int set_create(struct glyph_set *gs)
+{
+	int minx, maxx, miny, maxy;
+	char u8[3];
+	int i, j;
+
+	gs->height = TTF_GetFontHeight(gs->font);
+
+	for (i = 0; i < GLYPH_COUNT; i++) {
+		if (!TTF_GetGlyphMetrics(gs->font, charset[i], &minx, &maxx,
+			&miny, &maxy, &gs->advance[i]))
+		{
+			goto error;
+		}
+
+		gs->left[i]  = SDL_min(0, minx);
+		gs->right[i] = SDL_max(gs->advance[i], maxx);
+
+		for (j = 0; j < GLYPH_COUNT; j++)
+			if (!TTF_GetGlyphKerning(gs->font, charset[j], charset[i],
+				&gs->kern[j][i]))
+				gs->kern[j][i] = 0;
+
+		/* Blank glyphs (e.g., space) have nothing to draw. */
+		if (charset[i] == ' ')
+			continue;
+
+		if (charset[i] < 0x80) {
+			u8[0] = charset[i];
+			u8[1] = '\0';
+		} else {
+			u8[0] = 0xC0 | (charset[i] >> 6);
+			u8[1] = 0x80 | (charset[i] & 0x3F);
+			u8[2] = '\0';
+		}
+
+		gs->pending[i] = image_premultiply(
+			TTF_RenderText_Blended(gs->font, u8, 0, gs->color));
+		if (!gs->pending[i])
+			goto error;
+
+		/* The surface starts at the leftmost pixel, if it is
+		 * before the pen. */
+		gs->img[i].off.x = gs->left[i];
+	}
+	return (0);
+
+error:
+	for (i = 0; i < GLYPH_COUNT; i++) {
+		SDL_DestroySurface(gs->pending[i]);
+		gs->pending[i] = NULL;
+	}
+	return (-1);
+}
+
+/**
+ * @brief Finds (or creates) the glyph set for the font
+ * @p font and color @p color.
+ *
+ * Must be called with the lock held.
+ *
+ * @return Returns the set index, or -1 if not possible.
+ */
+static int set_get(TTF_Font *font, const SDL_Color *color)
+{
+	struct glyph_set *gs;
+	int i;
+
+	for (i = 0; i < nsets; i++) {
+		if (sets[i].font == font &&
+			!memcmp(&sets[i].color, color, sizeof(*color)))
+		{
+			return (i);
+		}
+	}
+
+	if (nsets == GLYPH_SETS)
+		return (-1);
+
+	gs = &sets[nsets];
+	memset(gs, 0, sizeof(*gs));
+	gs->font  = font;
+	gs->color = *color;
+
+	if (set_create(gs) < 0) {
+		log_info("Unable to create glyph set: %s\n", SDL_GetError());
+		return (-1);
+	}
+	return (nsets++);
+}
+
+/**
+ * @brief Initializes the glyph atlas.
+ */
+void glyph_init(void)
+{
+	lock = SDL_CreateMutex();
+	if (!lock)
+		log_panic("Unable to create glyph lock!\n");
+}
+
+/**
+ * @brief Releases all glyph sets.
+ */
+void glyph_quit(void)
+{
+	int i, j;
+
+	for (i = 0; i < nsets; i++) {
+		for (j = 0; j < GLYPH_COUNT; j++) {
+			SDL_DestroySurface(sets[i].pending[j]);
+			sets[i].pending[j] = NULL;
+		}
+	}
+	nsets = 0;
+	SDL_DestroyMutex(lock);
+}
+
+/**
+ * @brief Lays out the text @p text, with font @p font and
+ * color @p color, as a glyph run.
+ *
+ * Since this does not touch the renderer, it is meant
+ * to be called from the worker thread.
+ *
+ * @param run   Glyph run to be filled.
+ * @param font  Text font.
+ * @param color Text color.
+ * @param text  UTF-8 text.
+ *
+ * @return Returns 0 if success, -1 if the text can not
+ * be made of glyphs (and needs to be rasterized).
+ */
+int glyph_run_create(struct glyph_run *run, TTF_Font *font,
+	const SDL_Color *color, const char *text)
+{
+	const unsigned char *s;
+	struct glyph_set *gs;
+	int g, prev;
+	int pen;
+
+	memset(run, 0, sizeof(*run));
+
+	SDL_LockMutex(lock);
+
+	run->set = set_get(font, color);
+	if (run->set < 0)
+		goto error;
+
+	gs   = &sets[run->set];
+	s    = (const unsigned char *)text;
+	run->height = gs->height;
+	pen  = 0;
+	prev = -1;
+
+	while (*s) {
+		g = glyph_index(utf8_next(&s));
+		if (g < 0 || run->len == GLYPH_RUN_MAX)
+			goto error;
+
+		if (prev >= 0)
+			pen += gs->kern[prev][g];
+
+		run->glyph[run->len] = g;
+		run->x[run->len]     = pen;
+		run->left  = SDL_min(run->left,  pen + gs->left[g]);
+		run->width = SDL_max(run->width, pen + gs->right[g]);
+		run->len++;
+
+		pen += gs->advance[g];
+		prev = g;
+	}
+
+	SDL_UnlockMutex(lock);
+	return (0);
+
+error:
+	SDL_UnlockMutex(lock);
+	memset(run, 0, sizeof(*run));
+	return (-1);
+}
+
+/**
+ * @brief Uploads all glyph sets created since the last
+ * commit into the texture atlas.
+ *
+ * Must be called from the thread that owns the renderer,
+ * before drawing any run created since the last commit.
+ */
+void glyph_commit(void)
+{
+	struct glyph_set *gs;
+	int i, j, offx;
+
+	SDL_LockMutex(lock);
+	for (i = 0; i < nsets; i++) {
+		gs = &sets[i];
+		if (gs->uploaded)
+			continue;
+
+		for (j = 0; j < GLYPH_COUNT; j++) {
+			if (!gs->pending[j])
+				continue;
+
+			offx = gs->img[j].off.x;
+			if (image_glyph_upload(&gs->img[j], gs->pending[j]) < 0)
+				log_info("Not enough room in the atlas for glyphs!\n");
+			gs->img[j].off.x = offx;
+
+			SDL_DestroySurface(gs->pending[j]);
+			gs->pending[j] = NULL;
+		}
+		gs->uploaded = 1;
+	}
+	SDL_UnlockMutex(lock);
+}
+
+/**
+ * @brief Adds the glyph run @p run to the current image
+ * batch, at coordinates @p x and @p y.
+ *
+ * @param run Glyph run to be drawn.
+ * @param x   Screen X coordinate.
+ * @param y   Screen Y coordinate.
+ */
+void glyph_run_draw(const struct glyph_run *run, int x, int y)
+{
+	const struct glyph_set *gs;
+	int i;
+
+	if (!run->len)
+		return;
+
+	gs = &sets[run->set];
+	for (i = 0; i < run->len; i++)
+		image_batch_add(&gs->img[run->glyph[i]], x + run->x[i], y);
+}
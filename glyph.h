@@ -0,0 +1,61 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2026 Davidson Francis <davidsondfgl@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef GLYPH_H
+#define GLYPH_H
+
+	#include <SDL3/SDL.h>
+	#include "font.h"
+
+	/* Maximum glyphs per run. */
+	#define GLYPH_RUN_MAX 24
+
+	/*
+	 * A glyph run is a text already laid out from the
+	 * glyph atlas: which glyphs, and where (relative to
+	 * the text origin), so it can be drawn without any
+	 * rasterization. A run with len 0 is empty.
+	 *
+	 * 'left' (<= 0), 'width' and 'height' are the run
+	 * bounds, relative to the text origin.
+	 */
+	struct glyph_run
+	{
+		int set;
+		int len;
+		int left;
+		int width;
+		int height;
+		Uint8 glyph[GLYPH_RUN_MAX];
+		int x[GLYPH_RUN_MAX];
+	};
+
+	extern void glyph_init(void);
+	extern void glyph_quit(void);
+	extern int glyph_run_create(struct glyph_run *run, TTF_Font *font,
+		const SDL_Color *color, const char *text);
+	extern void glyph_commit(void);
+	extern void glyph_run_draw(const struct glyph_run *run, int x, int y);
+
+#endif /* GLYPH_H */
@@ -22,18 +22,355 @@
  * SOFTWARE.
  */
 
+#include <fcntl.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
+#include "blend.h"
+#include "image.h"
+#include "pack.h"
+#include "stats.h"
 #include "log.h"
 
-#define STBI_ONLY_PNG
-#define STB_IMAGE_IMPLEMENTATION
-#include "deps/stb_image.h"
-
 extern SDL_Renderer *renderer;
 
+/*
+ * Asset pack
+ *
+ * Images are not decoded at runtime: they come from
+ * the asset pack (see pack.h), either mapped from disk
+ * or embedded into the binary (WINDY_EMBED_PACK), and
+ * its pixels are uploaded straight from there.
+ */
+#ifdef WINDY_EMBED_PACK
+extern const unsigned char windy_pack[];
+extern const unsigned char windy_pack_end[];
+#endif
+
+static const unsigned char *pack;
+static size_t pack_size;
+static const struct pack_entry *pack_index;
+static uint32_t pack_count;
+
+/*
+ * Texture atlas
+ *
+ * Everything on screen lives in a single texture, so
+ * a whole frame can be drawn with a single geometry
+ * submission (and a single texture bind):
+ *
+ * - Static region: every pack image has a fixed place
+ *   (computed by mkpack), and is uploaded there the
+ *   first time it is used, and then kept for good.
+ *
+ * - Text region: right below the static one, holds
+ *   images that change on every update (i.e., texts),
+ *   and is entirely reset at each update.
+ *
+ * - Glyph region: at the bottom, holds images created
+ *   at runtime that are kept for good (i.e., glyphs).
+ *
+ * The atlas is only touched by the main thread, but the
+ * worker thread asks if an image is already uploaded (to
+ * avoid preparing it), hence the lock.
+ *
+ * Without a renderer (i.e., with the CPU compositor), the
+ * atlas is a plain surface, and batched images are blended
+ * straight into the target surface instead.
+ */
+#define TEXT_HEIGHT  256
+#define GLYPH_HEIGHT 256
+
+static SDL_Texture *atlas;
+static SDL_Surface *atlas_cpu;
+static int atlas_w;
+static int atlas_h;
+
+static struct image *images;
+static char *uploaded;
+static SDL_Mutex *cache_lock;
+
+/* Region 'shelf' allocator. */
+static struct shelf
+{
+	int y0;      /* Region top.            */
+	int y1;      /* Region bottom.         */
+	int x;       /* Current shelf X.       */
+	int y;       /* Current shelf Y.       */
+	int h;       /* Current shelf height.  */
+} text_shelf, glyph_shelf;
+
+/* Geometry batch. */
+#define BATCH_MAX 32
+
+static SDL_Vertex batch_vtx[BATCH_MAX * 4];
+static int batch_idx[BATCH_MAX * 6];
+static int batch_count;
+
+/* CPU batch target. */
+static SDL_Surface *blit_dst;
+static SDL_Rect blit_clip;
+
+/**
+ * @brief Copies the surface @p s into the atlas area @p r.
+ */
+static void atlas_update(const SDL_Rect *r, const SDL_Surface *s)
+{
+	Uint8 *d;
+	int y;
+
+	if (!atlas_cpu) {
+		SDL_UpdateTexture(atlas, r, s->pixels, s->pitch);
+		return;
+	}
+
+	d = (Uint8 *)atlas_cpu->pixels + r->y * atlas_cpu->pitch + r->x * 4;
+	for (y = 0; y < r->h; y++, d += atlas_cpu->pitch)
+		memcpy(d, (const Uint8 *)s->pixels + y * s->pitch, r->w * 4);
+}
+
+/**
+ * @brief Empties the atlas region @p sh.
+ */
+static void shelf_reset(struct shelf *sh)
+{
+	sh->x = 0;
+	sh->y = sh->y0;
+	sh->h = 0;
+}
+
+/**
+ * @brief Allocates room for the surface @p s in the
+ * atlas region @p sh and uploads it there.
+ *
+ * Images are placed side by side in 'shelves', and a
+ * new shelf is started once the current one is full.
+ *
+ * @param sh  Atlas region.
+ * @param img Image to be filled.
+ * @param s   Surface to be uploaded.
+ *
+ * @return Returns 0 if success, -1 if there is no room
+ * left (the image is then left empty).
+ */
+static int shelf_upload(struct shelf *sh, struct image *img, SDL_Surface *s)
+{
+	memset(img, 0, sizeof(*img));
+
+	if (s->w + PACK_ATLAS_PAD > atlas_w)
+		return (-1);
+
+	if (sh->x + s->w + PACK_ATLAS_PAD > atlas_w) {
+		sh->x  = 0;
+		sh->y += sh->h;
+		sh->h  = 0;
+	}
+
+	if (sh->y + s->h > sh->y1)
+		return (-1);
+
+	img->src.x = sh->x;
+	img->src.y = sh->y;
+	img->src.w = s->w;
+	img->src.h = s->h;
+	atlas_update(&img->src, s);
+
+	sh->x += s->w + PACK_ATLAS_PAD;
+	if (s->h + PACK_ATLAS_PAD > sh->h)
+		sh->h = s->h + PACK_ATLAS_PAD;
+
+	return (0);
+}
+
+/**
+ * @brief Maps the asset pack file into memory.
+ *
+ * @param size Pack size (output).
+ *
+ * @return Returns the pack contents.
+ */
+static const unsigned char *pack_map(size_t *size)
+{
+#ifdef WINDY_EMBED_PACK
+	*size = windy_pack_end - windy_pack;
+	return (windy_pack);
+#else
+	struct stat st;
+	void *p;
+	int fd;
+
+	fd = open(PACK_FILE, O_RDONLY|O_CLOEXEC);
+	if (fd < 0)
+		log_panic("Unable to open asset pack: %s!\n", PACK_FILE);
+
+	if (fstat(fd, &st) < 0 || st.st_size <= 0)
+		log_panic("Unable to stat asset pack: %s!\n", PACK_FILE);
+
+	p = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	if (p == MAP_FAILED)
+		log_panic("Unable to map asset pack: %s!\n", PACK_FILE);
+
+	close(fd);
+	*size = st.st_size;
+	return (p);
+#endif
+}
+
+/**
+ * @brief Loads and validates the asset pack.
+ *
+ * @param hdr Pack header (output).
+ */
+static void pack_open(const struct pack_header **hdr)
+{
+	const struct pack_entry *e;
+	uint32_t i;
+
+	pack = pack_map(&pack_size);
+	*hdr = (const struct pack_header *)pack;
+
+	if (pack_size < sizeof(**hdr)                              ||
+		memcmp((*hdr)->magic, PACK_MAGIC, sizeof((*hdr)->magic)) ||
+		(*hdr)->version != PACK_VERSION                        ||
+		(*hdr)->format  != PACK_FORMAT_ARGB8888_PREMUL         ||
+		(*hdr)->count > (pack_size - sizeof(**hdr)) / sizeof(*e))
+	{
+		log_panic("Invalid asset pack, please rebuild it!\n");
+	}
+
+	pack_index = (const struct pack_entry *)(*hdr + 1);
+	pack_count = (*hdr)->count;
+
+	for (i = 0; i < pack_count; i++) {
+		e = &pack_index[i];
+		if (e->offset > pack_size                          ||
+			(size_t)e->pitch * e->h > pack_size - e->offset ||
+			e->atlas_x + e->w > (*hdr)->atlas_w             ||
+			e->atlas_y + e->h > (*hdr)->atlas_h)
+		{
+			log_panic("Invalid asset pack, please rebuild it!\n");
+		}
+	}
+}
+
+/**
+ * @brief Unmaps the asset pack, if mapped from disk.
+ */
+static void pack_close(void)
+{
+#ifndef WINDY_EMBED_PACK
+	if (pack)
+		munmap((void *)pack, pack_size);
+#endif
+	pack = NULL;
+}
+
+/**
+ * @brief bsearch() comparator for pack entries.
+ */
+static int cmp_entry(const void *key, const void *entry)
+{
+	return (strcmp(key, ((const struct pack_entry *)entry)->name));
+}
+
+/**
+ * @brief Finds the image path @p img in the asset pack.
+ *
+ * @param img Image path.
+ *
+ * @return Returns the image index, aborts if not found.
+ */
+static int pack_find(const char *img)
+{
+	const struct pack_entry *e;
+
+	e = bsearch(img, pack_index, pack_count, sizeof(*e), cmp_entry);
+	if (!e)
+		log_panic("Unable to load image: %s!\n", img);
+
+	return (e - pack_index);
+}
+
+/**
+ * @brief Initializes the image subsystem: maps the asset
+ * pack and creates the texture atlas.
+ */
+void image_init(void)
+{
+	const struct pack_header *hdr;
+	const struct pack_entry *e;
+	uint32_t i;
+
+	pack_open(&hdr);
+
+	/* Static region + text region + glyph region. */
+	atlas_w = hdr->atlas_w;
+	atlas_h = hdr->atlas_h + TEXT_HEIGHT + GLYPH_HEIGHT;
+
+	text_shelf.y0  = hdr->atlas_h;
+	text_shelf.y1  = text_shelf.y0 + TEXT_HEIGHT;
+	glyph_shelf.y0 = text_shelf.y1;
+	glyph_shelf.y1 = atlas_h;
+	shelf_reset(&text_shelf);
+	shelf_reset(&glyph_shelf);
+
+	if (!renderer) {
+		atlas_cpu = SDL_CreateSurface(atlas_w, atlas_h,
+			SDL_PIXELFORMAT_ARGB8888);
+		if (!atlas_cpu)
+			log_panic("Unable to create atlas surface!: %s\n", SDL_GetError());
+	}
+
+	else {
+		atlas = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_ARGB8888,
+			SDL_TEXTUREACCESS_STATIC, atlas_w, atlas_h);
+		if (!atlas)
+			log_panic("Unable to create texture atlas!: %s\n", SDL_GetError());
+
+		/* Images are always drawn 1:1. */
+		SDL_SetTextureBlendMode(atlas, SDL_BLENDMODE_BLEND_PREMULTIPLIED);
+		SDL_SetTextureScaleMode(atlas, SDL_SCALEMODE_NEAREST);
+	}
+
+	images   = calloc(pack_count, sizeof(*images));
+	uploaded = calloc(pack_count, sizeof(*uploaded));
+	if (!images || !uploaded)
+		log_panic("Unable to allocate images!\n");
+
+	for (i = 0; i < pack_count; i++) {
+		e = &pack_index[i];
+		images[i].src.x = e->atlas_x;
+		images[i].src.y = e->atlas_y;
+		images[i].src.w = e->w;
+		images[i].src.h = e->h;
+		images[i].off.x = e->x;
+		images[i].off.y = e->y;
+	}
+
+	cache_lock = SDL_CreateMutex();
+	if (!cache_lock)
+		log_panic("Unable to create image cache lock!\n");
+}
+
+/**
+ * @brief Destroys the texture atlas and releases the
+ * asset pack.
+ */
+void image_quit(void)
+{
+	image_free(&atlas);
+	SDL_DestroySurface(atlas_cpu);
+	atlas_cpu = NULL;
+	SDL_DestroyMutex(cache_lock);
+	free(images);
+	free(uploaded);
+	pack_close();
+}
+
 /**
  * @brief If the texture pointed by @p tex exists,
  * free it, otherwise, do nothing.
@@ -49,70 +386,280 @@ void image_free(SDL_Texture **tex)
 }
 
 /**
- * @brief Load a given image path pointed by @p img, and
- * save into the texture pointer pointed by @p tex.
+ * @brief Gets the image path pointed by @p img from the
+ * asset pack, as a new SDL_Surface.
+ *
+ * The surface pixels point directly to the pack (which
+ * is never unmapped while windy runs), so no decoding or
+ * copy is involved. Since this does not touch the
+ * renderer, it is safe to be called from any thread.
  *
- * If the texture pointer already points to an existing
- * texture, the old texture is deallocated first.
+ * Only the visible rectangle of the image is returned.
  *
- * @param tex Texture pointer to be loaded.
  * @param img Image path.
+ *
+ * @return Returns the image surface.
  */
-void image_load(SDL_Texture **tex, const char *img)
+SDL_Surface *image_load_surface(const char *img)
 {
-	int w, h, comp;
+	const struct pack_entry *e;
 	SDL_Surface *s;
-	unsigned char *buff;
 
-	/* Silence 'defined but not used' stb_image warnings. */
-	((void)stbi__addints_valid);
-	((void)stbi__mul2shorts_valid);
+	e = &pack_index[pack_find(img)];
+
+	s = SDL_CreateSurfaceFrom(e->w, e->h, SDL_PIXELFORMAT_ARGB8888,
+		(void *)(pack + e->offset), e->pitch);
+	if (!s)
+		log_panic("Unable to create image surface!: %s\n", SDL_GetError());
 
-	image_free(tex);
+	return (s);
+}
 
-	comp = 4;
-	buff = stbi_load(img, &w, &h, &comp, 0);
-	if (!buff)
-		log_panic("Unable to load image: %s!\n", img);
+/**
+ * @brief Converts the surface @p s into premultiplied
+ * ARGB8888, the atlas format.
+ *
+ * Since this does not touch the renderer, it is safe to
+ * be called from any thread.
+ *
+ * @param s Surface to be converted, freed if a new one
+ *          needs to be created.
+ *
+ * @return Returns the converted surface, or NULL if
+ * @p s is NULL.
+ */
+SDL_Surface *image_premultiply(SDL_Surface *s)
+{
+	SDL_Surface *conv;
+	Uint32 *px, p, a;
+	int x, y;
 
-	s = SDL_CreateSurfaceFrom(w, h, SDL_PIXELFORMAT_RGBA32, buff, 4*w);
 	if (!s)
-		log_panic("Unable to create image surface!: %s\n", SDL_GetError());
+		return (NULL);
 
-	*tex = SDL_CreateTextureFromSurface(renderer, s);
-	if (!*tex)
-		log_panic("Unable to create image texture!\n");
+	if (s->format != SDL_PIXELFORMAT_ARGB8888) {
+		conv = SDL_ConvertSurface(s, SDL_PIXELFORMAT_ARGB8888);
+		SDL_DestroySurface(s);
+		if (!conv)
+			log_panic("Unable to convert surface!: %s\n", SDL_GetError());
+		s = conv;
+	}
+
+	for (y = 0; y < s->h; y++) {
+		px = (Uint32 *)((Uint8 *)s->pixels + y * s->pitch);
+		for (x = 0; x < s->w; x++) {
+			p = px[x];
+			a = p >> 24;
+			if (a == 255)
+				continue;
+			px[x] = (a << 24)                                  |
+				((((p >> 16) & 0xFF) * a + 127) / 255) << 16 |
+				((((p >>  8) & 0xFF) * a + 127) / 255) <<  8 |
+				((( p        & 0xFF) * a + 127) / 255);
+		}
+	}
+	return (s);
+}
+
+/**
+ * @brief Checks if the image path @p img is already in
+ * the texture atlas.
+ *
+ * Safe to be called from any thread.
+ *
+ * @param img Image path.
+ *
+ * @return Returns 1 if uploaded, 0 otherwise.
+ */
+int image_cached(const char *img)
+{
+	int idx;
+	int ret;
 
-	SDL_DestroySurface(s);
-	stbi_image_free(buff);
+	idx = pack_find(img);
+	SDL_LockMutex(cache_lock);
+	ret = uploaded[idx];
+	SDL_UnlockMutex(cache_lock);
+	return (ret);
 }
 
 /**
- * @brief Copy the texture pointed by @p tex into the
- * renderer, at coordinates @p x and @p y.
+ * @brief Gets the image path @p img from the texture
+ * atlas, uploading it first if needed.
  *
- * This is an small wrapper around 'SDL_RenderTexture',
- * with an additional check if the texture pointer is
- * valid or not, i.e., this function can be called
- * at any time, even if the texture does not exist
- * (NULL).
+ * @param img Image path.
+ * @param s   Image surface, as returned by image_load_surface(),
+ *            or NULL. Not freed.
  *
- * @param tex Texture to be rendered.
+ * @return Returns the image, valid until image_quit().
+ */
+const struct image *image_acquire(const char *img, SDL_Surface *s)
+{
+	SDL_Surface *loaded;
+	int idx;
+
+	idx = pack_find(img);
+
+	SDL_LockMutex(cache_lock);
+
+	if (uploaded[idx]) {
+		stats_inc(STATS_IMG_CACHE_HITS);
+		goto out;
+	}
+
+	stats_inc(STATS_IMG_CACHE_MISSES);
+
+	loaded = NULL;
+	if (!s)
+		s = loaded = image_load_surface(img);
+
+	if (s->w && s->h)
+		atlas_update(&images[idx].src, s);
+
+	SDL_DestroySurface(loaded);
+	uploaded[idx] = 1;
+
+out:
+	SDL_UnlockMutex(cache_lock);
+	return (&images[idx]);
+}
+
+/**
+ * @brief Releases all images in the text region of
+ * the atlas.
+ */
+void image_text_reset(void)
+{
+	shelf_reset(&text_shelf);
+}
+
+/**
+ * @brief Uploads the surface @p s into the text region
+ * of the atlas, valid until the next image_text_reset().
+ *
+ * @param img Image to be filled.
+ * @param s   Premultiplied ARGB8888 surface, as returned
+ *            by image_premultiply(). Not freed.
+ *
+ * @return Returns 0 if success, -1 if there is no room
+ * left (the image is then left empty).
+ */
+int image_text_upload(struct image *img, SDL_Surface *s)
+{
+	return (shelf_upload(&text_shelf, img, s));
+}
+
+/**
+ * @brief Uploads the surface @p s into the glyph region
+ * of the atlas, valid until image_quit().
+ *
+ * @param img Image to be filled.
+ * @param s   Premultiplied ARGB8888 surface, as returned
+ *            by image_premultiply(). Not freed.
+ *
+ * @return Returns 0 if success, -1 if there is no room
+ * left (the image is then left empty).
+ */
+int image_glyph_upload(struct image *img, SDL_Surface *s)
+{
+	return (shelf_upload(&glyph_shelf, img, s));
+}
+
+/**
+ * @brief Starts a new geometry batch.
+ */
+void image_batch_begin(void)
+{
+	batch_count = 0;
+}
+
+/**
+ * @brief Sets the surface @p dst as the target of the
+ * following batches, for the CPU compositor: images are
+ * then blended into @p dst, restricted to @p clip, instead
+ * of submitted to the renderer.
+ *
+ * @param dst  Premultiplied (X|A)RGB8888 surface, already
+ *             locked, if needed.
+ * @param clip Area of @p dst that can be touched.
+ */
+void image_batch_target(SDL_Surface *dst, const SDL_Rect *clip)
+{
+	blit_dst  = dst;
+	blit_clip = *clip;
+}
+
+/**
+ * @brief Submits all images in the current batch to
+ * the renderer, with a single draw call.
+ */
+void image_batch_draw(void)
+{
+	if (!batch_count)
+		return;
+
+	SDL_RenderGeometry(renderer, atlas, batch_vtx, batch_count * 4,
+		batch_idx, batch_count * 6);
+	batch_count = 0;
+}
+
+/**
+ * @brief Adds the image @p img to the current batch,
+ * at coordinates @p x and @p y.
+ *
+ * The image can be NULL or empty, in which case, nothing
+ * is added.
+ *
+ * @param img Image to be drawn.
  * @param x   Screen X coordinate.
  * @param y   Screen Y coordinate.
  */
-void image_render(SDL_Texture *tex, int x, int y)
+void image_batch_add(const struct image *img, int x, int y)
 {
-	SDL_FRect rect;
-	float w, h;
+	static const SDL_FColor white = {1.0f, 1.0f, 1.0f, 1.0f};
+	static const int quad[6] = {0, 1, 2, 2, 1, 3};
+	SDL_Vertex *v;
+	float u0, v0, u1, v1;
+	float x0, y0, x1, y1;
+	int *idx;
+	int i;
 
-	if (!tex)
+	if (!img || !img->src.w || !img->src.h)
 		return;
 
-	SDL_GetTextureSize(tex, &w, &h);
-	rect.x = x;
-	rect.y = y;
-	rect.w = w;
-	rect.h = h;
-	SDL_RenderTexture(renderer, tex, NULL, &rect);
+	if (atlas_cpu) {
+		blend_over(blit_dst, x + img->off.x, y + img->off.y, atlas_cpu,
+			&img->src, &blit_clip);
+		return;
+	}
+
+	if (batch_count == BATCH_MAX)
+		image_batch_draw();
+
+	x0 = x + img->off.x;
+	y0 = y + img->off.y;
+	x1 = x0 + img->src.w;
+	y1 = y0 + img->src.h;
+	u0 = (float)img->src.x / atlas_w;
+	v0 = (float)img->src.y / atlas_h;
+	u1 = (float)(img->src.x + img->src.w) / atlas_w;
+	v1 = (float)(img->src.y + img->src.h) / atlas_h;
+
+	v = &batch_vtx[batch_count * 4];
+	v[0].position.x = x0; v[0].position.y = y0;
+	v[1].position.x = x1; v[1].position.y = y0;
+	v[2].position.x = x0; v[2].position.y = y1;
+	v[3].position.x = x1; v[3].position.y = y1;
+	v[0].tex_coord.x = u0; v[0].tex_coord.y = v0;
+	v[1].tex_coord.x = u1; v[1].tex_coord.y = v0;
+	v[2].tex_coord.x = u0; v[2].tex_coord.y = v1;
+	v[3].tex_coord.x = u1; v[3].tex_coord.y = v1;
+	for (i = 0; i < 4; i++)
+		v[i].color = white;
+
+	idx = &batch_idx[batch_count * 6];
+	for (i = 0; i < 6; i++)
+		idx[i] = batch_count * 4 + quad[i];
+
+	batch_count++;
 }
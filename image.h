@@ -25,9 +25,45 @@
 #ifndef IMAGE_H
 #define IMAGE_H
 
+	#include <SDL3/SDL.h>
+
+	#include "pack.h"
+
+	/* Maximum image path size. */
+	#define IMAGE_PATH_MAX PACK_NAME_MAX
+
+	/*
+	 * An image placed in the texture atlas: 'src' is where
+	 * its (visible) pixels are in the atlas, and 'off' is
+	 * where they should be drawn, relative to the image
+	 * position.
+	 */
+	struct image
+	{
+		SDL_Rect src;
+		SDL_Point off;
+	};
+
+	extern void image_init(void);
+	extern void image_quit(void);
 	extern void image_free(SDL_Texture **tex);
-	extern void image_load(SDL_Texture **tex,
-		const char *img);
-	extern void image_render(SDL_Texture *tex, int x, int y);
+	extern SDL_Surface *image_load_surface(const char *img);
+	extern SDL_Surface *image_premultiply(SDL_Surface *s);
+
+	/* Static images, from the asset pack. */
+	extern int image_cached(const char *img);
+	extern const struct image *image_acquire(const char *img,
+		SDL_Surface *s);
+
+	/* Images created at runtime: texts and glyphs. */
+	extern void image_text_reset(void);
+	extern int image_text_upload(struct image *img, SDL_Surface *s);
+	extern int image_glyph_upload(struct image *img, SDL_Surface *s);
+
+	/* Batched drawing. */
+	extern void image_batch_begin(void);
+	extern void image_batch_target(SDL_Surface *dst, const SDL_Rect *clip);
+	extern void image_batch_add(const struct image *img, int x, int y);
+	extern void image_batch_draw(void);
 
 #endif /* IMAGE_H */
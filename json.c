@@ -0,0 +1,748 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2026 Davidson Francis <davidsondfgl@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "json.h"
+
+/* Parser states. */
+enum json_state
+{
+	ST_VALUE,        /* Expecting a value.                */
+	ST_OBJECT_FIRST, /* After '{': key or '}'.            */
+	ST_ARRAY_FIRST,  /* After '[': value or ']'.          */
+	ST_KEY,          /* After ',' in an object: key.      */
+	ST_COLON,        /* After a key: ':'.                 */
+	ST_NEXT,         /* After a value: ',' or '}'/']'.    */
+	ST_STRING,       /* Inside a string.                  */
+	ST_ESCAPE,       /* After a '\' inside a string.      */
+	ST_UNICODE,      /* Inside a \uXXXX escape.           */
+	ST_NUMBER,       /* Inside a number.                  */
+	ST_LITERAL,      /* Inside true/false/null.           */
+	ST_DONE,         /* Top-level value parsed.           */
+	ST_ERROR
+};
+
+/**
+ * @brief Checks if the char @p c is a json whitespace.
+ *
+ * @param c Character to be checked.
+ *
+ * @return Returns 1 if whitespace, 0 otherwise.
+ */
+static inline int is_space(char c)
+{
+	return (c == ' ' || c == '\t' || c == '\n' || c == '\r');
+}
+
+/**
+ * @brief Sets the parser @p jp into the error state
+ * with the message @p msg.
+ *
+ * @param jp  Json parser.
+ * @param msg Error message.
+ *
+ * @return Always JSON_ERROR.
+ */
+static int set_error(struct json_parser *jp, const char *msg)
+{
+	jp->state = ST_ERROR;
+	jp->error = msg;
+	return (JSON_ERROR);
+}
+
+/**
+ * @brief Appends the byte @p c into the current scalar,
+ * marking it as truncated if there is no room left.
+ *
+ * @param jp Json parser.
+ * @param c  Byte to be appended.
+ */
+static inline void put_byte(struct json_parser *jp, char c)
+{
+	if (jp->len < JSON_MAX_STR - 1)
+		jp->buf[jp->len++] = c;
+	else
+		jp->truncated = 1;
+}
+
+/**
+ * @brief Appends @p n bytes of @p s into the current
+ * scalar, truncating it if there is no room left.
+ *
+ * @param jp Json parser.
+ * @param s  Bytes to be appended.
+ * @param n  Amount of bytes.
+ */
+static inline void put_bytes(struct json_parser *jp, const char *s,
+	size_t n)
+{
+	size_t room;
+
+	room = JSON_MAX_STR - 1 - jp->len;
+	if (n > room) {
+		n = room;
+		jp->truncated = 1;
+	}
+	memcpy(jp->buf + jp->len, s, n);
+	jp->len += n;
+}
+
+/**
+ * @brief Appends the codepoint @p cp, UTF-8 encoded, into
+ * the current scalar.
+ *
+ * @param jp Json parser.
+ * @param cp Unicode codepoint.
+ */
+static void put_utf8(struct json_parser *jp, unsigned cp)
+{
+	if (cp < 0x80)
+		put_byte(jp, cp);
+	else if (cp < 0x800) {
+		put_byte(jp, 0xC0 | (cp >> 6));
+		put_byte(jp, 0x80 | (cp & 0x3F));
+	}
+	else if (cp < 0x10000) {
+		put_byte(jp, 0xE0 | (cp >> 12));
+		put_byte(jp, 0x80 | ((cp >> 6) & 0x3F));
+		put_byte(jp, 0x80 | (cp & 0x3F));
+	}
+	else {
+		put_byte(jp, 0xF0 | (cp >> 18));
+		put_byte(jp, 0x80 | ((cp >> 12) & 0x3F));
+		put_byte(jp, 0x80 | ((cp >> 6) & 0x3F));
+		put_byte(jp, 0x80 | (cp & 0x3F));
+	}
+}
+
+/**
+ * @brief Emits a pending (unpaired) high surrogate as
+ * the replacement character.
+ *
+ * @param jp Json parser.
+ */
+static inline void flush_surrogate(struct json_parser *jp)
+{
+	if (!jp->uhigh)
+		return;
+	put_utf8(jp, 0xFFFD);
+	jp->uhigh = 0;
+}
+
+/**
+ * @brief Removes an incomplete UTF-8 sequence at the end
+ * of the current (truncated) scalar, if any.
+ *
+ * @param jp Json parser.
+ */
+static void utf8_trim(struct json_parser *jp)
+{
+	unsigned char lead;
+	size_t cont;
+	size_t need;
+	size_t l;
+
+	l    = jp->len;
+	cont = 0;
+	while (l && ((unsigned char)jp->buf[l - 1] & 0xC0) == 0x80) {
+		l--;
+		cont++;
+	}
+
+	if (!l || !((unsigned char)jp->buf[l - 1] & 0x80))
+		return;
+
+	lead = jp->buf[l - 1];
+	need = (lead >= 0xF0) ? 3 : (lead >= 0xE0) ? 2 : 1;
+	if (cont < need)
+		jp->len = l - 1;
+}
+
+/**
+ * @brief Called when a value (scalar or a closed
+ * container) is over: moves to the next state.
+ *
+ * @param jp Json parser.
+ */
+static inline void value_done(struct json_parser *jp)
+{
+	jp->state = jp->depth ? ST_NEXT : ST_DONE;
+}
+
+/**
+ * @brief Invokes the user callback for the value @p v.
+ *
+ * @param jp Json parser.
+ * @param v  Parsed value.
+ *
+ * @return Returns 0 if success, JSON_ERROR if aborted.
+ */
+static int emit(struct json_parser *jp, struct json_value *v)
+{
+	if (jp->cb && jp->cb(jp->data, jp, v) < 0)
+		return (set_error(jp, "aborted"));
+	return (0);
+}
+
+/**
+ * @brief Finishes the current string, either storing it
+ * as the current key, or emitting it as a value.
+ *
+ * @param jp Json parser.
+ *
+ * @return Returns 0 if success, JSON_ERROR otherwise.
+ */
+static int string_done(struct json_parser *jp)
+{
+	struct json_value v;
+	char *key;
+
+	flush_surrogate(jp);
+
+	/* Do not leave a partial UTF-8 sequence behind. */
+	if (jp->truncated)
+		utf8_trim(jp);
+	jp->buf[jp->len] = '\0';
+
+	/*
+	 * Keys that do not fit are left empty, so that they
+	 * never match anything.
+	 */
+	if (jp->in_key) {
+		key = jp->key[jp->depth - 1];
+		if (jp->truncated || jp->len >= JSON_MAX_KEY)
+			key[0] = '\0';
+		else
+			memcpy(key, jp->buf, jp->len + 1);
+		jp->state = ST_COLON;
+		return (0);
+	}
+
+	memset(&v, 0, sizeof(v));
+	v.type      = JSON_STRING;
+	v.str       = jp->buf;
+	v.len       = jp->len;
+	v.truncated = jp->truncated;
+	if (emit(jp, &v) < 0)
+		return (JSON_ERROR);
+
+	value_done(jp);
+	return (0);
+}
+
+/**
+ * @brief Converts the plain decimal number @p s (i.e., no
+ * exponent), of length @p len, into a double.
+ *
+ * Weather values are small numbers, with few (if any)
+ * decimal places, which can be converted exactly (and
+ * much faster than strtod) as an integer division by a
+ * power of ten, as long as both are exactly representable
+ * as doubles.
+ *
+ * @param s   Number string.
+ * @param len Number length.
+ * @param out Converted number.
+ *
+ * @return Returns 0 if success, -1 if the number should
+ * be converted by strtod instead.
+ */
+static int fast_number(const char *s, size_t len, double *out)
+{
+	static const double pow10[] = {
+		1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10,
+		1e11, 1e12, 1e13, 1e14, 1e15
+	};
+	unsigned long long m;
+	const char *end;
+	int digits;
+	int frac;
+	int neg;
+
+	end    = s + len;
+	m      = 0;
+	digits = 0;
+	frac   = -1;
+	neg    = (*s == '-');
+	s     += neg;
+
+	if (s == end)
+		return (-1);
+
+	/* No leading zeros. */
+	if (s[0] == '0' && s + 1 < end && s[1] != '.')
+		return (-1);
+
+	for (; s < end; s++) {
+		if (*s >= '0' && *s <= '9') {
+			m = m * 10 + (*s - '0');
+			if (++digits > 15)
+				return (-1);
+			if (frac >= 0)
+				frac++;
+		}
+		else if (*s == '.' && frac < 0 && digits)
+			frac = 0;
+		else
+			return (-1);
+	}
+
+	if (!digits || frac == 0)
+		return (-1);
+
+	*out = (double)m;
+	if (frac > 0)
+		*out /= pow10[frac];
+	if (neg)
+		*out = -*out;
+	return (0);
+}
+
+/**
+ * @brief Finishes the current number and emits it.
+ *
+ * @param jp Json parser.
+ *
+ * @return Returns 0 if success, JSON_ERROR otherwise.
+ */
+static int number_done(struct json_parser *jp)
+{
+	struct json_value v;
+	char *end;
+
+	jp->buf[jp->len] = '\0';
+	if (jp->truncated || (jp->buf[0] != '-' &&
+		(jp->buf[0] < '0' || jp->buf[0] > '9')))
+	{
+		return (set_error(jp, "invalid number"));
+	}
+
+	memset(&v, 0, sizeof(v));
+	v.type = JSON_NUMBER;
+	v.str  = jp->buf;
+	v.len  = jp->len;
+
+	if (fast_number(jp->buf, jp->len, &v.number) < 0) {
+		v.number = strtod(jp->buf, &end);
+		if (end != jp->buf + jp->len)
+			return (set_error(jp, "invalid number"));
+	}
+
+	if (emit(jp, &v) < 0)
+		return (JSON_ERROR);
+
+	value_done(jp);
+	return (0);
+}
+
+/**
+ * @brief Starts a new value, beginning with the char @p c.
+ *
+ * @param jp Json parser.
+ * @param c  First char of the value.
+ *
+ * @return Returns 0 if success, JSON_ERROR otherwise.
+ */
+static int value_start(struct json_parser *jp, char c)
+{
+	struct json_value v;
+
+	jp->len       = 0;
+	jp->truncated = 0;
+
+	switch (c) {
+	case '{':
+	case '[':
+		if (jp->depth >= JSON_MAX_DEPTH)
+			return (set_error(jp, "too deeply nested"));
+
+		memset(&v, 0, sizeof(v));
+		v.type = (c == '{') ? JSON_OBJECT : JSON_ARRAY;
+		if (emit(jp, &v) < 0)
+			return (JSON_ERROR);
+
+		jp->container[jp->depth] = c;
+		jp->key[jp->depth][0]    = '\0';
+		jp->index[jp->depth]     = 0;
+		jp->depth++;
+		jp->state = (c == '{') ? ST_OBJECT_FIRST : ST_ARRAY_FIRST;
+		break;
+	case '"':
+		jp->in_key = 0;
+		jp->uhigh  = 0;
+		jp->state  = ST_STRING;
+		break;
+	case 't':
+		jp->literal = "true";
+		jp->len     = 1;
+		jp->state   = ST_LITERAL;
+		break;
+	case 'f':
+		jp->literal = "false";
+		jp->len     = 1;
+		jp->state   = ST_LITERAL;
+		break;
+	case 'n':
+		jp->literal = "null";
+		jp->len     = 1;
+		jp->state   = ST_LITERAL;
+		break;
+	default:
+		if (c == '-' || (c >= '0' && c <= '9')) {
+			put_byte(jp, c);
+			jp->state = ST_NUMBER;
+			break;
+		}
+		return (set_error(jp, "unexpected character"));
+	}
+	return (0);
+}
+
+/**
+ * @brief Closes the current container with the char @p c.
+ *
+ * @param jp Json parser.
+ * @param c  Closing char ('}' or ']').
+ *
+ * @return Returns 0 if success, JSON_ERROR otherwise.
+ */
+static int container_end(struct json_parser *jp, char c)
+{
+	char open;
+	open = (c == '}') ? '{' : '[';
+	if (!jp->depth || jp->container[jp->depth - 1] != open)
+		return (set_error(jp, "mismatched brackets"));
+	jp->depth--;
+	value_done(jp);
+	return (0);
+}
+
+/**
+ * @brief Process a single char @p c of the input.
+ *
+ * @param jp Json parser.
+ * @param c  Input char.
+ *
+ * @return Returns 0 if success, JSON_ERROR otherwise.
+ */
+static inline int feed_char(struct json_parser *jp, char c)
+{
+	int hex;
+
+again:
+	switch (jp->state) {
+	case ST_VALUE:
+		if (is_space(c))
+			return (0);
+		return (value_start(jp, c));
+
+	case ST_ARRAY_FIRST:
+		if (is_space(c))
+			return (0);
+		if (c == ']')
+			return (container_end(jp, c));
+		return (value_start(jp, c));
+
+	case ST_OBJECT_FIRST:
+		if (is_space(c))
+			return (0);
+		if (c == '}')
+			return (container_end(jp, c));
+		/* Fall through. */
+	case ST_KEY:
+		if (is_space(c))
+			return (0);
+		if (c != '"')
+			return (set_error(jp, "expected a key"));
+		jp->len       = 0;
+		jp->truncated = 0;
+		jp->uhigh     = 0;
+		jp->in_key    = 1;
+		jp->state     = ST_STRING;
+		return (0);
+
+	case ST_COLON:
+		if (is_space(c))
+			return (0);
+		if (c != ':')
+			return (set_error(jp, "expected ':'"));
+		jp->state = ST_VALUE;
+		return (0);
+
+	case ST_NEXT:
+		if (is_space(c))
+			return (0);
+		if (c == '}' || c == ']')
+			return (container_end(jp, c));
+		if (c != ',')
+			return (set_error(jp, "expected ',' or end of container"));
+		if (jp->container[jp->depth - 1] == '{')
+			jp->state = ST_KEY;
+		else {
+			jp->index[jp->depth - 1]++;
+			jp->state = ST_VALUE;
+		}
+		return (0);
+
+	case ST_STRING:
+		if (c == '"')
+			return (string_done(jp));
+		if (c == '\\') {
+			jp->state = ST_ESCAPE;
+			return (0);
+		}
+		if ((unsigned char)c < 0x20)
+			return (set_error(jp, "control character in string"));
+		flush_surrogate(jp);
+		put_byte(jp, c);
+		return (0);
+
+	case ST_ESCAPE:
+		jp->state = ST_STRING;
+		if (c == 'u') {
+			jp->ucode   = 0;
+			jp->udigits = 0;
+			jp->state   = ST_UNICODE;
+			return (0);
+		}
+		flush_surrogate(jp);
+		switch (c) {
+		case '"':  put_byte(jp, '"');  break;
+		case '\\': put_byte(jp, '\\'); break;
+		case '/':  put_byte(jp, '/');  break;
+		case 'b':  put_byte(jp, '\b'); break;
+		case 'f':  put_byte(jp, '\f'); break;
+		case 'n':  put_byte(jp, '\n'); break;
+		case 'r':  put_byte(jp, '\r'); break;
+		case 't':  put_byte(jp, '\t'); break;
+		default:
+			return (set_error(jp, "invalid escape"));
+		}
+		return (0);
+
+	case ST_UNICODE:
+		if (c >= '0' && c <= '9')
+			hex = c - '0';
+		else if (c >= 'a' && c <= 'f')
+			hex = c - 'a' + 10;
+		else if (c >= 'A' && c <= 'F')
+			hex = c - 'A' + 10;
+		else
+			return (set_error(jp, "invalid unicode escape"));
+
+		jp->ucode = (jp->ucode << 4) | hex;
+		if (++jp->udigits < 4)
+			return (0);
+
+		jp->state = ST_STRING;
+
+		/* High surrogate: wait for the low one. */
+		if (jp->ucode >= 0xD800 && jp->ucode <= 0xDBFF) {
+			flush_surrogate(jp);
+			jp->uhigh = jp->ucode;
+		}
+		else if (jp->ucode >= 0xDC00 && jp->ucode <= 0xDFFF) {
+			if (jp->uhigh)
+				put_utf8(jp, 0x10000 + ((jp->uhigh - 0xD800) << 10)
+					+ (jp->ucode - 0xDC00));
+			else
+				put_utf8(jp, 0xFFFD);
+			jp->uhigh = 0;
+		}
+		else {
+			flush_surrogate(jp);
+			put_utf8(jp, jp->ucode);
+		}
+		return (0);
+
+	case ST_NUMBER:
+		if ((c >= '0' && c <= '9') || c == '.' || c == 'e' ||
+			c == 'E' || c == '+' || c == '-')
+		{
+			put_byte(jp, c);
+			return (0);
+		}
+		if (number_done(jp) < 0)
+			return (JSON_ERROR);
+		goto again;
+
+	case ST_LITERAL:
+		if (c != jp->literal[jp->len])
+			return (set_error(jp, "invalid literal"));
+		if (jp->literal[++jp->len] == '\0') {
+			struct json_value v;
+			memset(&v, 0, sizeof(v));
+			if (jp->literal[0] == 'n')
+				v.type = JSON_NULL;
+			else {
+				v.type    = JSON_BOOL;
+				v.boolean = (jp->literal[0] == 't');
+			}
+			if (emit(jp, &v) < 0)
+				return (JSON_ERROR);
+			value_done(jp);
+		}
+		return (0);
+
+	/* Anything after the top-level value is ignored. */
+	case ST_DONE:
+		return (0);
+	}
+
+	return (JSON_ERROR);
+}
+
+/**
+ * @brief Initializes the json parser @p jp.
+ *
+ * @param jp   Json parser.
+ * @param cb   Value callback, invoked for every value.
+ * @param data User data passed to the callback.
+ */
+void json_init(struct json_parser *jp, json_value_cb cb, void *data)
+{
+	memset(jp, 0, sizeof(*jp));
+	jp->state = ST_VALUE;
+	jp->cb    = cb;
+	jp->data  = data;
+}
+
+/**
+ * @brief Feeds @p len bytes of @p buf into the parser.
+ *
+ * @param jp  Json parser.
+ * @param buf Input buffer.
+ * @param len Input length.
+ *
+ * @return Returns JSON_MORE if more data is expected,
+ * JSON_DONE if the top-level value was fully parsed (any
+ * remaining input is ignored), and JSON_ERROR if error
+ * (see jp->error and jp->pos).
+ */
+int json_feed(struct json_parser *jp, const char *buf, size_t len)
+{
+	size_t start;
+	size_t i;
+	int ret;
+
+	if (jp->state == ST_ERROR)
+		return (JSON_ERROR);
+
+	ret = JSON_MORE;
+	for (i = 0; i < len && jp->state != ST_DONE; ) {
+		/*
+		 * Fast paths: most of the input is whitespace or
+		 * plain string characters, so handle runs of them
+		 * at once, instead of char by char.
+		 */
+		if (jp->state == ST_STRING) {
+			start = i;
+			while (i < len && buf[i] != '"' && buf[i] != '\\' &&
+				(unsigned char)buf[i] >= 0x20)
+			{
+				i++;
+			}
+			if (i > start) {
+				flush_surrogate(jp);
+				put_bytes(jp, buf + start, i - start);
+				continue;
+			}
+		}
+		else if (jp->state != ST_NUMBER && jp->state != ST_LITERAL &&
+			jp->state != ST_ESCAPE && jp->state != ST_UNICODE &&
+			is_space(buf[i]))
+		{
+			i++;
+			continue;
+		}
+
+		if (feed_char(jp, buf[i]) < 0) {
+			ret = JSON_ERROR;
+			break;
+		}
+		i++;
+	}
+
+	jp->pos += i;
+	if (ret == JSON_ERROR)
+		return (ret);
+	return (jp->state == ST_DONE ? JSON_DONE : JSON_MORE);
+}
+
+/**
+ * @brief Signals the end of the input.
+ *
+ * @param jp Json parser.
+ *
+ * @return Returns JSON_DONE if a complete value was
+ * parsed, JSON_ERROR otherwise.
+ */
+int json_finish(struct json_parser *jp)
+{
+	/* A top-level number only ends with the input. */
+	if (jp->state == ST_NUMBER && jp->depth == 0)
+		number_done(jp);
+
+	if (jp->state == ST_DONE)
+		return (JSON_DONE);
+	if (jp->state != ST_ERROR)
+		set_error(jp, "unexpected end of input");
+	return (JSON_ERROR);
+}
+
+/**
+ * @brief Returns the object key at the path @p level,
+ * (0 is the top-level container).
+ *
+ * @param jp    Json parser.
+ * @param level Path level.
+ *
+ * @return Returns the key, or NULL if the container
+ * at this level is not an object.
+ */
+const char *json_path_key(const struct json_parser *jp, int level)
+{
+	if (level < 0 || level >= jp->depth || jp->container[level] != '{')
+		return (NULL);
+	return (jp->key[level]);
+}
+
+/**
+ * @brief Returns the array index at the path @p level,
+ * (0 is the top-level container).
+ *
+ * @param jp    Json parser.
+ * @param level Path level.
+ *
+ * @return Returns the index, or -1 if the container
+ * at this level is not an array.
+ */
+int json_path_index(const struct json_parser *jp, int level)
+{
+	if (level < 0 || level >= jp->depth || jp->container[level] != '[')
+		return (-1);
+	return (jp->index[level]);
+}
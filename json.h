@@ -0,0 +1,123 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2026 Davidson Francis <davidsondfgl@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef JSON_H
+#define JSON_H
+
+	#include <stddef.h>
+
+	/* Limits. */
+	#define JSON_MAX_DEPTH  8
+	#define JSON_MAX_KEY   32
+	#define JSON_MAX_STR  256
+
+	/* Value types. */
+	enum json_type
+	{
+		JSON_OBJECT,
+		JSON_ARRAY,
+		JSON_STRING,
+		JSON_NUMBER,
+		JSON_BOOL,
+		JSON_NULL
+	};
+
+	/* Feed return values. */
+	#define JSON_MORE   0 /* Need more data.       */
+	#define JSON_DONE   1 /* Top-level value done. */
+	#define JSON_ERROR -1 /* Parse error.          */
+
+	/*
+	 * Parsed value, as passed to the value callback.
+	 *
+	 * Objects and arrays are reported when they start,
+	 * scalars when they end. Strings longer than
+	 * JSON_MAX_STR-1 bytes are truncated and have
+	 * 'truncated' set.
+	 */
+	struct json_value
+	{
+		enum json_type type;
+		const char *str;
+		size_t len;
+		double number;
+		int boolean;
+		int truncated;
+	};
+
+	struct json_parser;
+
+	/*
+	 * Value callback: return 0 to continue parsing,
+	 * or -1 to abort.
+	 */
+	typedef int (*json_value_cb)(void *data, const struct json_parser *jp,
+		const struct json_value *v);
+
+	/*
+	 * Streaming (push) json parser.
+	 *
+	 * The input can be fed in chunks of any size, as they
+	 * arrive, and no memory is allocated: the parser only
+	 * keeps the current path (keys and array indexes) and
+	 * the current scalar value.
+	 */
+	struct json_parser
+	{
+		/* Current path. */
+		int depth;
+		char container[JSON_MAX_DEPTH];
+		char key[JSON_MAX_DEPTH][JSON_MAX_KEY];
+		int index[JSON_MAX_DEPTH];
+
+		/* Tokenizer state. */
+		int state;
+		int in_key;
+		size_t pos;
+
+		/* Current scalar. */
+		char buf[JSON_MAX_STR];
+		size_t len;
+		int truncated;
+		unsigned ucode;
+		unsigned uhigh;
+		int udigits;
+		const char *literal;
+
+		/* Callback. */
+		json_value_cb cb;
+		void *data;
+		const char *error;
+	};
+
+	extern void json_init(struct json_parser *jp, json_value_cb cb,
+		void *data);
+	extern int json_feed(struct json_parser *jp, const char *buf,
+		size_t len);
+	extern int json_finish(struct json_parser *jp);
+	extern const char *json_path_key(const struct json_parser *jp,
+		int level);
+	extern int json_path_index(const struct json_parser *jp, int level);
+
+#endif /* JSON_H */
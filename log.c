@@ -32,22 +32,25 @@
 
 /**
  * @brief Get the current timestamp (HH:MM:SS)
- * as a constant string.
+ * into the buffer @p buffer.
+ *
+ * Since logging might happen from more than one
+ * thread, no static storage is used here.
  *
  * If success, returns the timestamp, otherwise,
  * NULL.
  */
-static const char *get_timestamp(void)
+static const char *get_timestamp(char *buffer, size_t size)
 {
     time_t now;
-    struct tm *now_tm;
-    static char buffer[64];
+    struct tm now_tm;
 
-    now    = time(NULL);
-    now_tm = localtime(&now);
+    now = time(NULL);
+    if (!localtime_r(&now, &now_tm))
+    	return (NULL);
 
-    SDL_memset(buffer, 0, sizeof(buffer));
-    if (!strftime(buffer, sizeof(buffer), "%X", now_tm))
+    SDL_memset(buffer, 0, size);
+    if (!strftime(buffer, size, "%X", &now_tm))
     	return (NULL);
 
     return (buffer);
@@ -65,6 +68,7 @@ void log_msg(int priority,
 {
     va_list list;
     char log[2048];
+    char ts[64];
 
     /* Print log message into a buffer */
     SDL_memset(log, 0, sizeof log);
@@ -74,5 +78,5 @@ void log_msg(int priority,
 
 	/* Log with timestamp and newline */
     SDL_LogMessage(SDL_LOG_CATEGORY_APPLICATION,
-    	priority, "(%s) %s", get_timestamp(), log);
+    	priority, "(%s) %s", get_timestamp(ts, sizeof ts), log);
 }
@@ -22,17 +22,26 @@
  * SOFTWARE.
  */
 
-#include <ctype.h>
 #include <getopt.h>
 #include <stdlib.h>
 #include <stdio.h>
 #include <string.h>
+#include <time.h>
 #include <unistd.h>
 #include <SDL3/SDL.h>
 
+#include "blend.h"
 #include "font.h"
-#include "weather.h"
-#include "image.h"
+#include "provider.h"
+#include "openmeteo.h"
+#include "control.h"
+#include "bus.h"
+#include "watch.h"
+#include "refresh.h"
+#include "backoff.h"
+#include "scene.h"
+#include "stats.h"
+#include "worker.h"
 #include "log.h"
 
 /* Window size. */
@@ -40,145 +49,133 @@
 #define SCREEN_HEIGHT 270
 
 SDL_Renderer *renderer;
-static SDL_Window *window;
-
-/* Background image. */
-static SDL_Texture *bg_tex;
-
-/* Icon background (sun, moon...). */
-static SDL_Texture *bg_icon_tex;
-
-/* Loaded fonts and rendered texts. */
-static TTF_Font *font_16pt;
-static TTF_Font *font_18pt;
-static TTF_Font *font_40pt;
-static struct rendered_text txt_footer;
-static struct rendered_text txt_day1, txt_day2, txt_day3;
-static struct rendered_text txt_day1_min, txt_day1_max;
-static struct rendered_text txt_day2_min, txt_day2_max;
-static struct rendered_text txt_day3_min, txt_day3_max;
-static struct rendered_text txt_location;
-static struct rendered_text txt_curr_minmax;
-static struct rendered_text txt_curr_cond;
-static struct rendered_text txt_curr_temp;
-
-/* Forecast icons textures. */
-static SDL_Texture *fc_day1_tex;
-static SDL_Texture *fc_day2_tex;
-static SDL_Texture *fc_day3_tex;
-
-/* Text colors. */
-static SDL_Color color_blue  = {148,199,228,SDL_ALPHA_OPAQUE};
-static SDL_Color color_white = {255,255,255,SDL_ALPHA_OPAQUE};
-static SDL_Color color_gray  = {146,148,149,SDL_ALPHA_OPAQUE};
-static SDL_Color color_cloudy_gray = {162,179,189,SDL_ALPHA_OPAQUE};
-static SDL_Color color_black = {0,0,0,SDL_ALPHA_OPAQUE};
-
-/* Footer text, i.e., where the weather data
- * were obtained. */
-#define FOOTER_X  21
-#define FOOTER_Y 222
-#define FOOTER_MAX_WIDTH 292
-
-/* Forecast days. */
-#define DAY_Y    151 /* Y-axis for the days text.   */
-#define DAY1_X    16 /* Day 1 text forecast X-axis. */
-#define DAY2_X   116 /* Day 2 text forecast X-axis. */
-#define DAY3_X   230 /* Day 3 text forecast X-axis. */
-#define DAYMAX_Y 171 /* Day max 1-2-3 text Y-axis.  */
-#define DAYMIN_Y 189 /* Day min 1-2-3 text Y-axis.  */
-
-#define DAY_IMG_Y  165 /* Forecast images Y-axis.   */
-#define DAY1_IMG_X  45 /* Forecast day1 img X-axis. */
-#define DAY2_IMG_X 146 /* Forecast day1 img X-axis. */
-#define DAY3_IMG_X 257 /* Forecast day1 img X-axis. */
-
-/*
- * Header values
- *
- * Max X value to the header text,
- * which includes:
- * - Current temperature
- * - Weather condition
- * - Min/max temperature
- * - Location
- *
- * X value is dynamically calculated
- */
-#define HDR_MAX_X    310
-
-/* Header Y-values. */
-#define HDR_TEMP_Y    15
-#define HDR_COND_Y    60
-#define HDR_MINMAX_Y  83
-#define HDR_LOC_Y    120
-#define HDR_MAX_WIDTH FOOTER_MAX_WIDTH
-
-/* Current weather info. */
-static struct weather_info wi = {0};
+SDL_Window *window;
 
 /* Command-line arguments. */
 static struct args {
-	const char *execute_command;
+	const char *execute_command; /* First -c. */
+	const char *commands[PROVIDER_MAX];
+	int ncommands;
+	const char *plugin;
+	const char *openmeteo;
+	const char *control;
+	const char *watch;
 	Uint32 update_weather_time_ms;
+	Uint32 jitter_ms;
+	Uint32 min_update_ms;
+	Uint32 max_update_ms;
+	int max_failures;
+	struct provider_limits limits;
+	int persistent;
+	int bus;
 	int x;
 	int y;
 	int verbose;
 } args = {
 	.execute_command = NULL,
+	.plugin = NULL,
+	.openmeteo = NULL,
+	.control = NULL,
+	.watch = NULL,
 	.update_weather_time_ms = 600*1000,
+	.jitter_ms = 0,
+	.min_update_ms = 60*1000,
+	.max_update_ms = 3600*1000,
+	.max_failures = BACKOFF_MAX_FAILURES,
+	.limits = {
+		.timeout_ms = 30*1000,
+		.hedge_ms = 3*1000,
+		.max_output = 1024*1024,
+	},
+	.persistent = 0,
+	.bus = 0,
 	.x = -1,
 	.y = -1,
 	.verbose = 0
 };
 
-/* Forward definitions. */
-static void create_texts(
-	const SDL_Color *days_color,
-	const SDL_Color *max_temp_color,
-	const SDL_Color *hdr_color);
-static Uint32 update_weather_cb(void *userdata,
-	SDL_TimerID timerID, Uint32 interval);
+/* Weather providers. */
+static struct provider providers[PROVIDER_MAX];
+
+/* Main loop event actions. */
+enum { EV_NONE, EV_REDRAW, EV_QUIT };
+
+/* Whether the window can be seen at all. */
+static int visible = 1;
+
+/* Next time the scene changes by itself, see weather_next_change(). */
+static time_t scene_deadline;
+
+/**
+ * @brief Returns the time left until the scene changes by
+ * itself (day/night, weekdays), in milliseconds, suitable
+ * for SDL_WaitEventTimeout().
+ */
+static Sint32 scene_timeout(void)
+{
+	Sint64 secs;
+
+	secs = (Sint64)(scene_deadline - time(NULL));
+	if (secs <= 0)
+		return (0);
+	if (secs > SDL_MAX_SINT32 / 1000)
+		return (SDL_MAX_SINT32);
+	return ((Sint32)(secs * 1000));
+}
+
+/**
+ * @brief Checks if the scene changed by itself and, if
+ * so, schedules the next change.
+ *
+ * @return Returns 1 if the scene should be rebuilt, 0
+ * otherwise.
+ */
+static int scene_due(void)
+{
+	if (time(NULL) < scene_deadline)
+		return (0);
+	scene_deadline = weather_next_change();
+	return (1);
+}
 
 /**
- * Update logic and drawing for each frame
+ * @brief Chooses how the scene is drawn: if SDL fell back
+ * to its software renderer (i.e., no GPU), the renderer
+ * is dropped in favor of the CPU compositor, which blends
+ * straight into the window surface (see scene.c).
+ *
+ * Otherwise (or if the window surface format is not
+ * supported), the renderer is kept.
  */
-static inline void update_frame(void)
+static void select_render_path(void)
 {
-	/* Draw background alpha image. */
-	SDL_RenderClear(renderer);
-
-	/* Backgruond and icon. */
-	SDL_RenderTexture(renderer, bg_tex, NULL, NULL);
-	image_render(bg_icon_tex, 0,0);
-
-	/* Footer and forecast days text. */
-	font_render_text(&txt_footer, FOOTER_X, FOOTER_Y);
-	font_render_text(&txt_day1, DAY1_X, DAY_Y);
-	font_render_text(&txt_day2, DAY2_X, DAY_Y);
-	font_render_text(&txt_day3, DAY3_X, DAY_Y);
-
-	/* Forecast days min and max temp. */
-	font_render_text(&txt_day1_max, DAY1_X, DAYMAX_Y);
-	font_render_text(&txt_day2_max, DAY2_X, DAYMAX_Y);
-	font_render_text(&txt_day3_max, DAY3_X, DAYMAX_Y);
-	font_render_text(&txt_day1_min, DAY1_X, DAYMIN_Y);
-	font_render_text(&txt_day2_min, DAY2_X, DAYMIN_Y);
-	font_render_text(&txt_day3_min, DAY3_X, DAYMIN_Y);
-
-	/* Header: curr temp, condition, min/max and location. */
-	font_render_text(&txt_curr_temp,   HDR_MAX_X - txt_curr_temp.width,   HDR_TEMP_Y);
-	font_render_text(&txt_curr_cond,   HDR_MAX_X - txt_curr_cond.width,   HDR_COND_Y);
-	font_render_text(&txt_curr_minmax, HDR_MAX_X - txt_curr_minmax.width, HDR_MINMAX_Y);
-	font_render_text(&txt_location,    HDR_MAX_X - txt_location.width,    HDR_LOC_Y);
-
-	/* Forecast icons based on weather condition. */
-	image_render(fc_day1_tex, DAY1_IMG_X, DAY_IMG_Y);
-	image_render(fc_day2_tex, DAY2_IMG_X, DAY_IMG_Y);
-	image_render(fc_day3_tex, DAY3_IMG_X, DAY_IMG_Y);
-
-	/* Render everything. */
-	SDL_RenderPresent(renderer);
+	SDL_Surface *s;
+	const char *name;
+
+	name = SDL_GetRendererName(renderer);
+	if (!name || strcmp(name, SDL_SOFTWARE_RENDERER))
+		goto out;
+
+	SDL_DestroyRenderer(renderer);
+	renderer = NULL;
+
+	s = SDL_GetWindowSurface(window);
+	if (s && (s->format == SDL_PIXELFORMAT_ARGB8888 ||
+		s->format == SDL_PIXELFORMAT_XRGB8888))
+	{
+		blend_init();
+		log_info("Using CPU compositor (%s)\n", blend_name());
+		return;
+	}
+
+	SDL_DestroyWindowSurface(window);
+	renderer = SDL_CreateRenderer(window, SDL_SOFTWARE_RENDERER);
+	if (!renderer)
+		log_panic("Unable to create renderer!: %s\n", SDL_GetError());
+	SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_BLEND);
+
+out:
+	log_info("Using renderer: %s\n", name ? name : "unknown");
 }
 
 /**
@@ -196,6 +193,7 @@ static int create_sdl_window(int w, int h, int flags)
 		log_panic("Unable to create window and renderer!\n");
 
 	SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_BLEND);
+	select_render_path();
 
 	/* Set coordinates. */
 	if (args.x >= 0 && args.y >= 0)
@@ -205,235 +203,136 @@ static int create_sdl_window(int w, int h, int flags)
 }
 
 /**
- * @brief 'Main' weather update routine.
+ * @brief SDL event filter: only lets through the events
+ * the main loop cares about, so that everything else
+ * (mouse motion, focus changes, clipboard...) neither
+ * gets queued nor wakes the main loop up.
+ *
+ * This might be called from any thread.
  *
- * Executes the command given, read its output in stdout,
- * parse its json and then choose which text/icons should
- * be loaded into the screen.
+ * @param userdata Unused.
+ * @param event    Event about to be queued.
+ *
+ * @return Returns true if @p event should be queued,
+ * false otherwise.
  */
-static void update_weather_info(void)
+static bool event_filter(void *userdata, SDL_Event *event)
 {
-	const SDL_Color *cd, *cmt, *chdr;
-	const char *bg_icon_tex_path;
-	const char *wbg;
-
-	char buff1[32] = {0};
-	char buff2[32] = {0};
-	char buff3[32] = {0};
-
-	log_info("Updating weather info...\n");
-
-	if (weather_get(args.execute_command, &wi) < 0)
-		log_err_to(out, "Unable to get weather info!\n");
-
-	/* Icon to be loaded if not 'clear'. */
-	snprintf(buff1,
-		sizeof buff1,
-		"assets/bg_icon_%s.png",
-		wi.condition);
-
-	bg_icon_tex_path = buff1;
-
-	/* Load background depending of time and weather condition. */
-	if (!weather_is_day()) {
-		wbg = "assets/bg_night.png";
-
-		/*
-		 * Load moon or other weather icons, accordingly
-		 * to the weather condition.
-		 */
-		if (!strcmp(wi.condition, "clear"))
-			bg_icon_tex_path = weather_get_moon_phase_icon();
-
-		cd   = &color_gray;
-		cmt  = &color_white;
-		chdr = &color_white;
-	}
-
-	/* If day. */
-	else {
-		/* If clear. */
-		if (!strcmp(wi.condition, "clear")) {
-			bg_icon_tex_path = NULL;
-			wbg  = "assets/bg_sunny_day.png";
-			cd   = &color_blue;
-			cmt  = &color_white;
-			chdr = &color_black;
-		}
+	((void)userdata);
 
-		/* Anything else, should load bg and icon. */
-		else {
-			wbg  = "assets/bg_notclear_day.png";
-			cd   = &color_cloudy_gray;
-			cmt  = &color_white;
-			chdr = &color_black;
-		}
+	switch (event->type) {
+	case SDL_EVENT_QUIT:
+	case SDL_EVENT_USER:
+	case SDL_EVENT_RENDER_TARGETS_RESET:
+	case SDL_EVENT_RENDER_DEVICE_RESET:
+	case SDL_EVENT_WINDOW_EXPOSED:
+	case SDL_EVENT_WINDOW_RESIZED:
+	case SDL_EVENT_WINDOW_PIXEL_SIZE_CHANGED:
+	case SDL_EVENT_WINDOW_DISPLAY_SCALE_CHANGED:
+	case SDL_EVENT_WINDOW_CLOSE_REQUESTED:
+	case SDL_EVENT_WINDOW_SHOWN:
+	case SDL_EVENT_WINDOW_HIDDEN:
+	case SDL_EVENT_WINDOW_MINIMIZED:
+	case SDL_EVENT_WINDOW_RESTORED:
+	case SDL_EVENT_WINDOW_OCCLUDED:
+	case SDL_EVENT_DID_ENTER_BACKGROUND:
+	case SDL_EVENT_WILL_ENTER_FOREGROUND:
+	case SDL_EVENT_DISPLAY_CONTENT_SCALE_CHANGED:
+		return (true);
+	case SDL_EVENT_WINDOW_MOVED:
+		return (args.verbose);
+	default:
+		return (false);
 	}
-
-	image_free(&bg_icon_tex);
-	image_load(&bg_tex, wbg);
-	if (bg_icon_tex_path)
-		image_load(&bg_icon_tex, bg_icon_tex_path);
-
-	create_texts(cd, cmt, chdr);
-
-	/* Forecast days icons. */
-	snprintf(buff1, sizeof buff1, "assets/%s.png",
-		wi.forecast[0].condition);
-	snprintf(buff2, sizeof buff2, "assets/%s.png",
-		wi.forecast[1].condition);
-	snprintf(buff3, sizeof buff3, "assets/%s.png",
-		wi.forecast[2].condition);
-
-	image_load(&fc_day1_tex, buff1);
-	image_load(&fc_day2_tex, buff2);
-	image_load(&fc_day3_tex, buff3);
-
-out:
-	SDL_AddTimer(args.update_weather_time_ms,
-		update_weather_cb, NULL);
 }
 
 /**
- * @brief Load the same font in three diferent sizes
- * for the GUI texts.
- */
-static void load_fonts(void)
-{
-	/* Load require fonts and sizes. */
-	font_16pt = font_open("assets/fonts/NotoSans-Regular.ttf", 16);
-	if (!font_16pt)
-		log_panic("Unable to open font with size 16pt!\n");
-	font_18pt = font_open("assets/fonts/NotoSans-Regular.ttf", 18);
-	if (!font_18pt)
-		log_panic("Unable to open font with size 18pt!\n");
-	font_40pt = font_open("assets/fonts/NotoSans-Regular.ttf", 40);
-	if (!font_40pt)
-		log_panic("Unable to open font with size 40pt!\n");
-}
-
-/**
- * @brief Create all texts/textures to the GUI.
+ * @brief Sets whether the window is visible or not.
  *
- * @param days_color     Color of footer, days and min temp.
- * @param max_temp_color Color of the max temp color for the
- *                       forecast days.
- * @param hdr_color      Header color (curr temp, location...)
+ * While not visible, nothing is rendered and weather
+ * updates are deferred, and once visible again, a single
+ * update catches up with everything missed.
+ *
+ * @param v 1 if visible, 0 otherwise.
  */
-static void create_texts(
-	const SDL_Color *days_color,
-	const SDL_Color *max_temp_color,
-	const SDL_Color *hdr_color)
+static void set_visible(int v)
 {
-	int d1, d2, d3;
-	char buff1[32] = {0};
-	char buff2[32] = {0};
-	char buff3[32] = {0};
-
-	static const char *const days_of_week[] = {
-		"sunday",
-		"monday",
-		"tuesday",
-		"wednesday",
-		"thursday",
-		"friday",
-		"saturday"
-	};
-
-	weather_get_forecast_days(&d1, &d2, &d3);
-
-	/* Footer. */
-	font_create_text(&txt_footer, font_16pt, wi.provider, days_color,
-		FOOTER_MAX_WIDTH);
-
-	/* Forecast days string. */
-	font_create_text(&txt_day1, font_16pt, days_of_week[d1], days_color, 0);
-	font_create_text(&txt_day2, font_16pt, days_of_week[d2], days_color, 0);
-	font_create_text(&txt_day3, font_16pt, days_of_week[d3], days_color, 0);
-
-	/* Max temperature value. */
-	snprintf(buff1, sizeof buff1, "%dº", wi.forecast[0].max_temp);
-	snprintf(buff2, sizeof buff2, "%dº", wi.forecast[1].max_temp);
-	snprintf(buff3, sizeof buff3, "%dº", wi.forecast[2].max_temp);
-
-	font_create_text(&txt_day1_max, font_16pt, buff1, max_temp_color, 0);
-	font_create_text(&txt_day2_max, font_16pt, buff2, max_temp_color, 0);
-	font_create_text(&txt_day3_max, font_16pt, buff3, max_temp_color, 0);
-
-	/* Min temperature value. */
-	snprintf(buff1, sizeof buff1, "%dº", wi.forecast[0].min_temp);
-	snprintf(buff2, sizeof buff2, "%dº", wi.forecast[1].min_temp);
-	snprintf(buff3, sizeof buff3, "%dº", wi.forecast[2].min_temp);
-
-	font_create_text(&txt_day1_min, font_16pt, buff1, days_color, 0);
-	font_create_text(&txt_day2_min, font_16pt, buff2, days_color, 0);
-	font_create_text(&txt_day3_min, font_16pt, buff3, days_color, 0);
-
-	/* Header: location, max/min, current condition and temperature. */
-	snprintf(buff1, sizeof buff1, "%dº - %dº", wi.max_temp, wi.min_temp);
-	snprintf(buff2, sizeof buff2, "%c%s",
-		toupper(wi.condition[0]), wi.condition+1);
-	snprintf(buff3, sizeof buff3, "%dº", wi.temperature);
-
-	font_create_text(&txt_location, font_18pt, wi.location, hdr_color,
-		HDR_MAX_WIDTH);
-	font_create_text(&txt_curr_minmax, font_18pt, buff1, hdr_color, 0);
-	font_create_text(&txt_curr_cond, font_18pt, buff2, hdr_color, 0);
-	font_create_text(&txt_curr_temp, font_40pt, buff3, hdr_color, 0);
-}
+	if (v == visible)
+		return;
 
-/**
- * @brief Free all fonts and textures used.
- */
-void free_resources(void)
-{
-	/* Free textures. */
-	image_free(&bg_tex);
-	image_free(&bg_icon_tex);
-	image_free(&fc_day1_tex);
-	image_free(&fc_day2_tex);
-	image_free(&fc_day3_tex);
-	font_destroy_text(&txt_footer);
-	font_destroy_text(&txt_day1);
-	font_destroy_text(&txt_day2);
-	font_destroy_text(&txt_day3);
-	font_destroy_text(&txt_day1_max);
-	font_destroy_text(&txt_day2_max);
-	font_destroy_text(&txt_day3_max);
-	font_destroy_text(&txt_day1_min);
-	font_destroy_text(&txt_day2_min);
-	font_destroy_text(&txt_day3_min);
-	font_destroy_text(&txt_curr_temp);
-	font_destroy_text(&txt_curr_cond);
-	font_destroy_text(&txt_curr_minmax);
-	font_destroy_text(&txt_location);
-	font_destroy_text(&txt_curr_temp);
-
-	/* Close loaded fonts. */
-	font_close(font_16pt);
-	font_close(font_18pt);
-	font_close(font_40pt);
+	visible = v;
+	log_info("Window %s, %s updates\n", v ? "visible" : "not visible",
+		v ? "resuming" : "pausing");
+
+	worker_pause(!v);
 }
 
 /**
- * @brief SDL timer callback to update the weather
+ * @brief Handles a single event of the main loop.
+ *
+ * @param event Event to be handled.
  *
- * @param userdata Custom data
- * @param timerID  Current timer being processed.
- * @param interval Current timer interval
- * @return Returns the time of the next callback, 0
- * to disable.
+ * @return Returns EV_QUIT if the program should quit,
+ * EV_REDRAW if the scene needs to be rendered again, or
+ * EV_NONE otherwise.
  */
-static Uint32 update_weather_cb(void *userdata, SDL_TimerID timerID, Uint32 interval)
+static int handle_event(const SDL_Event *event)
 {
-	((void)userdata);
-	((void)timerID);
-	((void)interval);
-	SDL_Event event;
-	event.type       = SDL_EVENT_USER;
-	event.user.data1 = NULL;
-	SDL_PushEvent(&event);
-	return (0);
+	struct scene_frame frame;
+
+	switch (event->type) {
+	case SDL_EVENT_QUIT:
+		return (EV_QUIT);
+
+	/* New frame from the worker. */
+	case SDL_EVENT_USER:
+		if (!worker_take_frame(&frame))
+			return (EV_NONE);
+		scene_commit(&frame);
+		if (args.verbose)
+			stats_log();
+		return (EV_REDRAW);
+
+	/* Scene texture contents were lost, compose it again. */
+	case SDL_EVENT_RENDER_TARGETS_RESET:
+	case SDL_EVENT_RENDER_DEVICE_RESET:
+		scene_invalidate();
+		return (EV_REDRAW);
+
+	/* Only moves are not worth a redraw. */
+	case SDL_EVENT_WINDOW_MOVED:
+		printf("Window position: x=%d, y=%d\n",
+			event->window.data1,
+			event->window.data2);
+		return (EV_NONE);
+
+	case SDL_EVENT_WINDOW_CLOSE_REQUESTED:
+		return (EV_NONE);
+
+	/*
+	 * Visibility changes. Note that there is no event for the
+	 * display going off, but compositors usually report the
+	 * window as occluded then.
+	 */
+	case SDL_EVENT_WINDOW_HIDDEN:
+	case SDL_EVENT_WINDOW_MINIMIZED:
+	case SDL_EVENT_WINDOW_OCCLUDED:
+	case SDL_EVENT_DID_ENTER_BACKGROUND:
+		set_visible(0);
+		return (EV_NONE);
+
+	case SDL_EVENT_WINDOW_SHOWN:
+	case SDL_EVENT_WINDOW_RESTORED:
+	case SDL_EVENT_WINDOW_EXPOSED:
+	case SDL_EVENT_WILL_ENTER_FOREGROUND:
+		set_visible(1);
+		return (EV_REDRAW);
+
+	/* Anything else that passed the filter invalidates the
+	 * window contents. */
+	default:
+		return (EV_REDRAW);
+	}
 }
 
 /**
@@ -442,23 +341,89 @@ static Uint32 update_weather_cb(void *userdata, SDL_TimerID timerID, Uint32 inte
  */
 void usage(const char *prgname)
 {
-	fprintf(stderr, "Usage: %s [options] -c <command-to-run>\n",
-		prgname);
+	fprintf(stderr, "Usage: %s [options] -c <command-to-run>\n"
+		"       %s [options] -p <plugin.so> [-c <plugin-arg>]\n"
+		"       %s [options] -o <lat>,<long>[,<location>]\n"
+		"       %s [options] -s <socket>\n"
+		"       %s [options] -f <file>\n",
+		prgname, prgname, prgname, prgname, prgname);
 	fprintf(stderr,
 		"Options:\n"
 		"  -t           Interval time (in seconds) to check for weather\n"
-		"               updates (default = 10 minutes)\n"
-		"  -c <command> Command to execute when the update time reaches\n"
+		"               updates (default = 10 minutes), aligned to the clock,\n"
+		"               e.g., at :00, :10, :20... for 10 minutes\n"
+		"  -j <secs>    Delay each update by a random time of up to <secs>\n"
+		"               seconds, so that many instances do not all update\n"
+		"               at the same time (default = 0)\n"
+		"  -m <secs>    Minimum interval between updates when following the\n"
+		"               provider hints, see below (default = 1 minute)\n"
+		"  -M <secs>    Maximum interval between updates when following the\n"
+		"               provider hints (default = 1 hour)\n"
+		"  -B <n>       After a failed update, the next ones are backed\n"
+		"               off exponentially (up to -M), and after <n>\n"
+		"               failures in a row, the provider is only probed\n"
+		"               every -M, until it answers again (default = 5,\n"
+		"               0 = never)\n"
+		"  -c <command> Command to execute when the update time reaches.\n"
+		"               Can be given up to 4 times, in priority order: if\n"
+		"               a command does not answer within its budget, the\n"
+		"               next one is started as well, and the first valid\n"
+		"               answer wins\n"
+		"  -H <ms>      Maximum budget (in ms) for each command, before\n"
+		"               starting the next one, lower for commands that\n"
+		"               usually answer faster (default = 3000)\n"
+		"  -k           Keep the command running (co-process mode): it is\n"
+		"               started only once, and for each update, windy\n"
+		"               writes a newline into its stdin and reads a single\n"
+		"               json line from its stdout\n"
+		"  -p <plugin>  Load the provider plugin (shared object) <plugin>\n"
+		"               and call it in-process, instead of running a\n"
+		"               command. If given, -c is passed to the plugin\n"
+		"               as its argument\n"
+		"  -o <lat>,<long>[,<location>]\n"
+		"               Use the built-in Open-Meteo provider for the given\n"
+		"               coordinates, instead of running a command\n"
+		"  -s <socket>  Listen at the Unix socket <socket> for weather json\n"
+		"               pushed by other programs, one per line, and for\n"
+		"               the commands 'refresh' and 'stats'. Can be used\n"
+		"               with or without a provider\n"
+		"  -f <file>    Show the weather json at <file>, parsed again only\n"
+		"               when it changes (inotify). Can be used with or\n"
+		"               without a provider\n"
+		"  -b           Share the weather with the other instances (of\n"
+		"               the same user) that use the same provider: only\n"
+		"               one of them runs it, for all\n"
+		"  -T <secs>    Kill the command if it takes longer than <secs>\n"
+		"               seconds to answer (default = 30, 0 = no limit)\n"
+		"  -S <bytes>   Kill the command if it outputs more than <bytes>\n"
+		"               bytes (default = 1 MiB, 0 = no limit)\n"
+		"  -n <inc>     Run the command with its nice value increased by\n"
+		"               <inc> (default = 0)\n"
+		"  -I           Run the command with idle CPU and I/O priority\n"
+		"  -A <MiB>     Limit the command address space to <MiB> MiB\n"
+		"  -C <secs>    Limit the command CPU time to <secs> seconds\n"
 		"  -x <pos>     Set the window X coordinate\n"
 		"  -y <pos>     Set the window Y coordinate\n"
 		"  -v           Verbose mode: print window coordinates when it moves\n"
+		"               and internal stats (e.g., cache hits) on updates\n"
 		"  -h           This help\n\n"
 		"Example:\n"
 		" Update the weather info each 30 minutes, by running the command\n"
 		" 'python request.py'\n"
 		"    $ %s -t 1800 -c \"python request.py\"\n\n"
-		"Obs: Options -t,-x,-y and -v are not required, -c is required!\n",
-		prgname);
+		" Same as above, but keeping the script running between updates\n"
+		"    $ %s -t 1800 -k -c \"python request.py --persistent\"\n\n"
+		" Same as above, but with the example plugin\n"
+		"    $ %s -t 1800 -p plugins/fixed.so -c \"Tokyo, Japan\"\n\n"
+		" Same as above, but with the built-in Open-Meteo provider\n"
+		"    $ %s -t 1800 -o \"35.69,139.69,Tokyo, Japan\"\n\n"
+		" Many instances (e.g., one per screen), showing the same city\n"
+		"    $ %s -b -o \"35.69,139.69,Tokyo, Japan\"\n\n"
+		" Only show what other programs push into /tmp/windy.sock\n"
+		"    $ %s -s /tmp/windy.sock\n\n"
+		"Obs: Only -c (or -p, -o, -s, -f) is required, all the other options\n"
+		"     are not!\n",
+		prgname, prgname, prgname, prgname, prgname, prgname);
 	exit(EXIT_FAILURE);
 }
 
@@ -471,7 +436,7 @@ void usage(const char *prgname)
 void parse_args(int argc, char **argv)
 {
 	int c; /* Current arg. */
-	while ((c = getopt(argc, argv, "t:c:x:y:vh")) != -1)
+	while ((c = getopt(argc, argv, "t:j:m:M:B:c:H:kp:o:s:f:bT:S:n:IA:C:x:y:vh")) != -1)
 	{
 		switch (c) {
 		case 'h':
@@ -484,8 +449,73 @@ void parse_args(int argc, char **argv)
 				usage(argv[0]);
 			}
 			break;
+		case 'j':
+			args.jitter_ms = atoi(optarg)*1000;
+			break;
+		case 'm':
+			args.min_update_ms = atoi(optarg)*1000;
+			if (!args.min_update_ms) {
+				log_info("Invalid -m value, please choose a valid interval!\n");
+				usage(argv[0]);
+			}
+			break;
+		case 'M':
+			args.max_update_ms = atoi(optarg)*1000;
+			if (!args.max_update_ms) {
+				log_info("Invalid -M value, please choose a valid interval!\n");
+				usage(argv[0]);
+			}
+			break;
+		case 'B':
+			args.max_failures = atoi(optarg);
+			break;
 		case 'c':
-			args.execute_command = optarg;
+			if (args.ncommands == PROVIDER_MAX) {
+				log_info("Too many -c, up to %d are supported!\n",
+					PROVIDER_MAX);
+				usage(argv[0]);
+			}
+			args.commands[args.ncommands++] = optarg;
+			args.execute_command = args.commands[0];
+			break;
+		case 'H':
+			args.limits.hedge_ms = atoi(optarg);
+			break;
+		case 'k':
+			args.persistent = 1;
+			break;
+		case 'p':
+			args.plugin = optarg;
+			break;
+		case 'o':
+			args.openmeteo = optarg;
+			break;
+		case 's':
+			args.control = optarg;
+			break;
+		case 'f':
+			args.watch = optarg;
+			break;
+		case 'b':
+			args.bus = 1;
+			break;
+		case 'T':
+			args.limits.timeout_ms = atoi(optarg)*1000;
+			break;
+		case 'S':
+			args.limits.max_output = atoi(optarg);
+			break;
+		case 'n':
+			args.limits.nice = atoi(optarg);
+			break;
+		case 'I':
+			args.limits.idle = 1;
+			break;
+		case 'A':
+			args.limits.max_as = strtoul(optarg, NULL, 10) * 1024 * 1024;
+			break;
+		case 'C':
+			args.limits.max_cpu = strtoul(optarg, NULL, 10);
 			break;
 		case 'x':
 			args.x = atoi(optarg);
@@ -502,12 +532,47 @@ void parse_args(int argc, char **argv)
 		}
 	}
 
-	if (!args.execute_command) {
-		log_info("Option -c is required!\n");
+	if (!args.execute_command && !args.plugin && !args.openmeteo &&
+		!args.control && !args.watch)
+	{
+		log_info("Option -c (or -p, -o, -s, -f) is required!\n");
+		usage(argv[0]);
+	}
+
+	if (args.ncommands > 1 && (args.plugin || args.openmeteo)) {
+		log_info("Options -p and -o take a single -c!\n");
+		usage(argv[0]);
+	}
+
+	if (args.bus && !args.execute_command && !args.plugin &&
+		!args.openmeteo)
+	{
+		log_info("Option -b requires a provider (-c, -p or -o)!\n");
 		usage(argv[0]);
 	}
 }
 
+/**
+ * @brief Opens the weather bus for the provider in use,
+ * i.e., named after the provider command, plugin or
+ * Open-Meteo coordinates.
+ */
+static void open_bus(void)
+{
+	char key[1024];
+
+	if (args.openmeteo)
+		snprintf(key, sizeof(key), "openmeteo:%s", args.openmeteo);
+	else if (args.plugin)
+		snprintf(key, sizeof(key), "plugin:%s:%s", args.plugin,
+			args.execute_command ? args.execute_command : "");
+	else
+		snprintf(key, sizeof(key), "command:%s", args.execute_command);
+
+	/* Longest an update might take to come, see backoff.c. */
+	bus_open(key, SDL_max(args.update_weather_time_ms, args.max_update_ms));
+}
+
 /**
  * Main weather loop.
  */
@@ -515,6 +580,11 @@ int main(int argc, char **argv)
 {
 	const char *base_path;
 	SDL_Event event;
+	int have_event;
+	int polling; /* Amount of providers. */
+	Sint32 timeout;
+	int redraw;
+	int i;
 
 	parse_args(argc, argv);
 
@@ -533,6 +603,13 @@ int main(int argc, char **argv)
 		log_panic("SDL could not initialize!: %s\n", SDL_GetError());
 	if (font_init() < 0)
 		log_panic("Unable to initialize SDL_ttf!\n");
+	stats_init();
+
+	/* Before leaving the current directory. */
+	if (args.watch)
+		watch_open(args.watch);
+	if (args.control)
+		control_open(args.control);
 
 	base_path = SDL_GetBasePath();
 	if (!base_path)
@@ -545,47 +622,95 @@ int main(int argc, char **argv)
 		SDL_WINDOW_BORDERLESS|
 		SDL_WINDOW_UTILITY);
 
-	image_load(&bg_tex, "assets/bg_sunny_day.png");
-	load_fonts();
+	scene_init();
+
+	/* With -s and/or -f alone, there is nothing to poll. */
+	polling = 1;
+	if (args.openmeteo)
+		provider_init_builtin(&providers[0], &openmeteo_plugin, args.openmeteo);
+	else if (args.plugin)
+		provider_init_plugin(&providers[0], args.plugin, args.execute_command);
+	else if (args.ncommands) {
+		for (i = 0; i < args.ncommands; i++)
+			provider_init(&providers[i], args.commands[i], args.persistent,
+				&args.limits);
+		polling = args.ncommands;
+	}
+	else
+		polling = 0;
+
+	if (polling) {
+		refresh_init(args.update_weather_time_ms, args.jitter_ms,
+			args.min_update_ms, args.max_update_ms);
+		backoff_init(args.update_weather_time_ms, args.max_update_ms,
+			args.max_failures);
+	}
+	if (args.bus)
+		open_bus();
+
+	worker_start(providers, polling);
+	bus_follow();
+	watch_start();
 
-	update_weather_info();
+	control_start();
 
-	/* Ignore some events that might wake us up
-	 * everytime. */
-	SDL_SetEventEnabled(SDL_EVENT_CLIPBOARD_UPDATE, 0);
+	/* Drop, before they are even queued, all events that
+	 * are unrelated to us. */
+	SDL_SetEventFilter(event_filter, NULL);
 
+	/*
+	 * Wait for events (or the next refresh, or the next
+	 * scene change, even with no provider), then drain
+	 * everything queued so far, and render (at most) once
+	 * for the whole batch.
+	 */
+	scene_deadline = weather_next_change();
 	while (1)
 	{
-		while (SDL_WaitEvent(&event) != 0) {
-			if (event.type == SDL_EVENT_QUIT)
+		timeout = scene_timeout();
+		if (polling)
+			timeout = SDL_min(timeout, refresh_timeout());
+
+		have_event = SDL_WaitEventTimeout(&event, timeout);
+		if (polling && refresh_due())
+			worker_request_update();
+		if (scene_due())
+			worker_refresh_scene();
+		if (!have_event)
+			continue;
+
+		stats_inc(STATS_WAKEUPS);
+		redraw = 0;
+
+		do {
+			stats_inc(STATS_EVENTS);
+			switch (handle_event(&event)) {
+			case EV_QUIT:
 				goto quit;
-			else if (event.type == SDL_EVENT_USER) {
-				update_weather_info();
-				update_frame();
+			case EV_REDRAW:
+				redraw = 1;
+				break;
 			}
+		} while (SDL_PollEvent(&event));
 
-			/* Only redraw if there is a WINDOW* or DISPLAY*
-			 * event, as most events are unrelated to us. */
-			else if
-				((event.type >= SDL_EVENT_WINDOW_FIRST  &&
-				  event.type <= SDL_EVENT_WINDOW_LAST)  ||
-				((event.type >= SDL_EVENT_DISPLAY_FIRST &&
-				  event.type <= SDL_EVENT_DISPLAY_LAST)))
-			{
-				if (args.verbose &&
-					event.type == SDL_EVENT_WINDOW_MOVED)
-				{
-					printf("Window position: x=%d, y=%d\n",
-						event.window.data1,
-						event.window.data2);
-				}
-				update_frame();
-			}
-		}
+		if (redraw && visible)
+			scene_render();
 	}
 
 quit:
-	free_resources();
+	control_stop();
+	watch_stop();
+	bus_close();
+
+	/*
+	 * If the worker is still busy with a provider, it
+	 * might be still using the fonts, so leave all the
+	 * cleanup to the OS.
+	 */
+	if (worker_stop() < 0)
+		return (0);
+
+	scene_quit();
 
 	if (renderer)
 		SDL_DestroyRenderer(renderer);
@@ -0,0 +1,760 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2026 Davidson Francis <davidsondfgl@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#define _GNU_SOURCE /* strcasestr(). */
+#include <errno.h>
+#include <limits.h>
+#include <math.h>
+#include <netdb.h>
+#include <poll.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "openmeteo.h"
+#include "json.h"
+#include "log.h"
+
+/* Socket timeout, for each connect/send/recv, in seconds. */
+#define OM_TIMEOUT 15
+
+/* Whole fetch timeout (connect and exchange), in seconds,
+ * so a server trickling its answer cannot hold us forever. */
+#define OM_DEADLINE 30
+
+/* Most header (and trailer) lines accepted. */
+#define OM_MAX_HEADERS 64
+
+/* Biggest accepted answer body (the usual is ~1 KiB). */
+#define OM_MAX_BODY (1024 * 1024)
+
+#define OM_QUERY \
+	"/v1/forecast?latitude=%.4f&longitude=%.4f&current_weather=true" \
+	"&daily=weathercode,temperature_2m_max,temperature_2m_min" \
+	"&timezone=auto&forecast_days=4"
+
+/* Open-Meteo (WMO) weather codes, as in request.py. */
+static const char *const conditions[100] = {
+	[0]  = "clear",    /* Clear sky.                          */
+	[1]  = "clear",    /* Mainly clear.                       */
+	[2]  = "clear",    /* Partly cloudy.                      */
+	[3]  = "clouds",   /* Overcast.                           */
+	[45] = "fog",      /* Fog.                                */
+	[48] = "fog",      /* Depositing rime fog.                */
+	[51] = "showers",  /* Drizzle: Light intensity.           */
+	[53] = "showers",  /* Drizzle: Moderate intensity.        */
+	[55] = "showers",  /* Drizzle: Dense intensity.           */
+	[56] = "showers",  /* Freezing Drizzle: Light intensity.  */
+	[57] = "showers",  /* Freezing Drizzle: Dense intensity.  */
+	[61] = "rainfall", /* Rain: Slight intensity.             */
+	[63] = "rainfall", /* Rain: Moderate intensity.           */
+	[65] = "rainfall", /* Rain: Heavy intensity.              */
+	[66] = "rainfall", /* Freezing Rain: Light intensity.     */
+	[67] = "rainfall", /* Freezing Rain: Heavy intensity.     */
+	[71] = "snow",     /* Snow fall: Slight intensity.        */
+	[73] = "snow",     /* Snow fall: Moderate intensity.      */
+	[75] = "snow",     /* Snow fall: Heavy intensity.         */
+	[77] = "snow",     /* Snow grains.                        */
+	[80] = "rainfall", /* Rain showers: Slight intensity.     */
+	[81] = "rainfall", /* Rain showers: Moderate intensity.   */
+	[82] = "rainfall", /* Rain showers: Violent intensity.    */
+	[85] = "snow",     /* Snow showers: Slight intensity.     */
+	[86] = "snow",     /* Snow showers: Heavy intensity.      */
+	[95] = "thunder",  /* Thunderstorm: Slight or moderate.   */
+	[96] = "thunder",  /* Thunderstorm: With slight hail.     */
+	[99] = "thunder",  /* Thunderstorm: With heavy hail.      */
+};
+
+/* Provider context. */
+struct openmeteo
+{
+	char request[512];
+	char location[WEATHER_STR_SIZE];
+	char host[128];
+	char port[8];
+	int fd;
+
+	/* Current fetch deadline, in ms (monotonic). */
+	long long deadline;
+
+	/* Receive buffer, headers must fit in. */
+	char buf[8192];
+	size_t off;
+	size_t len;
+};
+
+/* Answer parser state. */
+struct om_parser
+{
+	struct json_parser jp;
+	double temp;
+	int code;
+	double max[4];
+	double min[4];
+	int codes[4];
+	unsigned seen;
+};
+
+/* om_parser 'seen' bits. */
+#define SEEN_TEMP  (1u << 0)
+#define SEEN_CODE  (1u << 1)
+#define SEEN_MAX(i)   (1u << (2 + (i)))
+#define SEEN_MIN(i)   (1u << (6 + (i)))
+#define SEEN_CODES(i) (1u << (10 + (i)))
+#define SEEN_ALL   ((1u << 14) - 1)
+
+/**
+ * @brief Returns the windy condition for the Open-Meteo
+ * weather code @p code, or NULL if unknown.
+ */
+static const char *condition(int code)
+{
+	if (code < 0 || code >= (int)(sizeof(conditions)/sizeof(conditions[0])))
+		return (NULL);
+	return (conditions[code]);
+}
+
+/**
+ * @brief Closes the connection, if any.
+ *
+ * @param om Provider context.
+ */
+static void om_close(struct openmeteo *om)
+{
+	if (om->fd >= 0)
+		close(om->fd);
+	om->fd  = -1;
+	om->off = 0;
+	om->len = 0;
+}
+
+/**
+ * @brief Returns the current monotonic time, in ms.
+ */
+static long long om_now(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (ts.tv_sec * 1000LL + ts.tv_nsec / 1000000);
+}
+
+/**
+ * @brief Returns the time left until the fetch deadline,
+ * in milliseconds (0 if already expired).
+ */
+static int om_left(const struct openmeteo *om)
+{
+	long long now;
+
+	now = om_now();
+	if (now >= om->deadline)
+		return (0);
+	return ((int)(om->deadline - now));
+}
+
+/**
+ * @brief Connects to the server.
+ *
+ * @param om Provider context.
+ *
+ * @return Returns 0 if success, -1 otherwise.
+ */
+static int om_connect(struct openmeteo *om)
+{
+	struct addrinfo hints, *res, *ai;
+	struct timeval tv;
+	int ret;
+	int fd;
+
+	memset(&hints, 0, sizeof(hints));
+	hints.ai_family   = AF_UNSPEC;
+	hints.ai_socktype = SOCK_STREAM;
+
+	if ((ret = getaddrinfo(om->host, om->port, &hints, &res)))
+		log_err_to(out0, "Open-Meteo: unable to resolve %s: %s\n",
+			om->host, gai_strerror(ret));
+
+	/* Within the fetch deadline, as well. */
+	tv.tv_sec  = om_left(om) / 1000 + 1;
+	tv.tv_usec = 0;
+	if (tv.tv_sec > OM_TIMEOUT)
+		tv.tv_sec = OM_TIMEOUT;
+	fd = -1;
+
+	for (ai = res; ai; ai = ai->ai_next) {
+		fd = socket(ai->ai_family, ai->ai_socktype|SOCK_CLOEXEC,
+			ai->ai_protocol);
+		if (fd < 0)
+			continue;
+
+		/* Also bounds connect(), on Linux. */
+		setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+		setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &tv, sizeof(tv));
+
+		if (!connect(fd, ai->ai_addr, ai->ai_addrlen))
+			break;
+
+		close(fd);
+		fd = -1;
+	}
+
+	freeaddrinfo(res);
+	if (fd < 0)
+		log_err_to(out0, "Open-Meteo: unable to connect to %s:%s: %s\n",
+			om->host, om->port, strerror(errno));
+
+	om->fd  = fd;
+	om->off = 0;
+	om->len = 0;
+	return (0);
+out0:
+	return (-1);
+}
+
+/**
+ * @brief Reads more data from the server into the
+ * receive buffer.
+ *
+ * @param om Provider context.
+ *
+ * @return Returns the amount of bytes read, 0 if the
+ * connection was closed, -1 if error.
+ */
+static ssize_t om_fill(struct openmeteo *om)
+{
+	struct pollfd pfd;
+	ssize_t r;
+	int left;
+
+	if (om->off == om->len)
+		om->off = om->len = 0;
+
+	if (om->len == sizeof(om->buf))
+		return (-1);
+
+	pfd.fd     = om->fd;
+	pfd.events = POLLIN;
+	do {
+		if (!(left = om_left(om))) {
+			log_info("Open-Meteo: timed out (%d s)!\n", OM_DEADLINE);
+			return (-1);
+		}
+		r = poll(&pfd, 1, left);
+	} while ((r < 0 && errno == EINTR) || !r);
+	if (r < 0)
+		return (-1);
+
+	do {
+		r = recv(om->fd, om->buf + om->len, sizeof(om->buf) - om->len, 0);
+	} while (r < 0 && errno == EINTR);
+
+	if (r > 0)
+		om->len += r;
+	return (r);
+}
+
+/**
+ * @brief Reads a line (CRLF or LF terminated) from the
+ * server.
+ *
+ * @param om   Provider context.
+ * @param line Line read, NUL-terminated and without the
+ *             line terminator. Valid until the next read.
+ *
+ * @return Returns 0 if success, -1 otherwise (error,
+ * connection closed or line too long).
+ */
+static int om_line(struct openmeteo *om, char **line)
+{
+	char *nl;
+
+	for (;;) {
+		nl = memchr(om->buf + om->off, '\n', om->len - om->off);
+		if (nl)
+			break;
+
+		/* Make room for the rest of the line. */
+		memmove(om->buf, om->buf + om->off, om->len - om->off);
+		om->len -= om->off;
+		om->off  = 0;
+
+		if (om_fill(om) <= 0)
+			return (-1);
+	}
+
+	*nl = '\0';
+	if (nl > om->buf + om->off && nl[-1] == '\r')
+		nl[-1] = '\0';
+
+	*line   = om->buf + om->off;
+	om->off = nl - om->buf + 1;
+	return (0);
+}
+
+/**
+ * @brief Takes up to @p max bytes from the server.
+ *
+ * @param om  Provider context.
+ * @param max Maximum amount of bytes.
+ * @param p   Bytes taken, valid until the next read.
+ *
+ * @return Returns the amount of bytes taken, 0 if the
+ * connection was closed, -1 if error.
+ */
+static ssize_t om_take(struct openmeteo *om, size_t max, const char **p)
+{
+	ssize_t r;
+	size_t n;
+
+	if (om->off == om->len && (r = om_fill(om)) <= 0)
+		return (r);
+
+	n = om->len - om->off;
+	if (n > max)
+		n = max;
+
+	*p = om->buf + om->off;
+	om->off += n;
+	return (n);
+}
+
+/**
+ * @brief Feeds @p len bytes of body to the json parser.
+ *
+ * @param om  Provider context.
+ * @param op  Answer parser.
+ * @param len Amount of body bytes.
+ *
+ * @return Returns 0 if success, -1 otherwise.
+ */
+static int om_body(struct openmeteo *om, struct om_parser *op, size_t len)
+{
+	const char *p;
+	ssize_t r;
+
+	while (len) {
+		if ((r = om_take(om, len, &p)) <= 0)
+			return (-1);
+		if (json_feed(&op->jp, p, r) == JSON_ERROR)
+			return (-1);
+		len -= r;
+	}
+	return (0);
+}
+
+/**
+ * @brief Rounds the json number @p n to the nearest int,
+ * saturating it.
+ *
+ * @param n Number to be rounded.
+ *
+ * @return Returns the rounded number.
+ */
+static int om_round(double n)
+{
+	if (n >= INT_MAX)
+		return (INT_MAX);
+	if (n <= (double)INT_MIN)
+		return (INT_MIN);
+	return ((int)lround(n));
+}
+
+/**
+ * @brief Json value callback: saves the current weather
+ * and the daily values, ignoring everything else.
+ *
+ * @param data Answer parser.
+ * @param jp   Json parser.
+ * @param v    Parsed value.
+ *
+ * @return Always 0.
+ */
+static int om_value(void *data, const struct json_parser *jp,
+	const struct json_value *v)
+{
+	struct om_parser *op;
+	const char *k0, *k1;
+	int i;
+
+	op = data;
+	if (v->type != JSON_NUMBER || !(k0 = json_path_key(jp, 0)))
+		return (0);
+
+	/* {"current_weather": {"key": value}}. */
+	if (jp->depth == 2 && !strcmp(k0, "current_weather")) {
+		k1 = json_path_key(jp, 1);
+		if (!k1)
+			return (0);
+
+		if (!strcmp(k1, "temperature")) {
+			op->temp  = v->number;
+			op->seen |= SEEN_TEMP;
+		} else if (!strcmp(k1, "weathercode")) {
+			op->code  = om_round(v->number);
+			op->seen |= SEEN_CODE;
+		}
+	}
+
+	/* {"daily": {"key": [value, ...]}}. */
+	else if (jp->depth == 3 && !strcmp(k0, "daily")) {
+		k1 = json_path_key(jp, 1);
+		i  = json_path_index(jp, 2);
+		if (!k1 || i < 0 || i > 3)
+			return (0);
+
+		if (!strcmp(k1, "temperature_2m_max")) {
+			op->max[i] = v->number;
+			op->seen  |= SEEN_MAX(i);
+		} else if (!strcmp(k1, "temperature_2m_min")) {
+			op->min[i] = v->number;
+			op->seen  |= SEEN_MIN(i);
+		} else if (!strcmp(k1, "weathercode")) {
+			op->codes[i] = om_round(v->number);
+			op->seen    |= SEEN_CODES(i);
+		}
+	}
+	return (0);
+}
+
+/**
+ * @brief Sends the request and reads (and parses) the
+ * answer, over the current connection.
+ *
+ * @param om    Provider context.
+ * @param op    Answer parser.
+ * @param retry Set if nothing at all was received,
+ *              i.e., the request can be retried on a
+ *              new connection.
+ *
+ * @return Returns 0 if success, -1 otherwise.
+ */
+static int om_exchange(struct openmeteo *om, struct om_parser *op,
+	int *retry)
+{
+	size_t req_len, total;
+	long content_len;
+	unsigned long chunk;
+	const char *p;
+	int chunked;
+	int status;
+	int keep;
+	char *line;
+	ssize_t r;
+	int n;
+
+	*retry  = 0;
+	om->off = 0;
+	om->len = 0;
+	req_len = strlen(om->request);
+
+	if (send(om->fd, om->request, req_len, MSG_NOSIGNAL) != (ssize_t)req_len) {
+		*retry = 1;
+		return (-1);
+	}
+
+	/* Status line. */
+	if (om_line(om, &line) < 0) {
+		*retry = (om->len == 0);
+		return (-1);
+	}
+	if (sscanf(line, "HTTP/1.%*d %d", &status) != 1)
+		log_err_to(out0, "Open-Meteo: invalid answer: %.64s\n", line);
+
+	keep = strncmp(line, "HTTP/1.0", 8) != 0;
+
+	/* Headers. */
+	content_len = -1;
+	chunked     = 0;
+	for (n = 0;; n++) {
+		if (n == OM_MAX_HEADERS)
+			log_err_to(out0, "Open-Meteo: too many headers!\n");
+		if (om_line(om, &line) < 0)
+			log_err_to(out0, "Open-Meteo: unable to read headers!\n");
+		if (!line[0])
+			break;
+
+		if (!strncasecmp(line, "Content-Length:", 15))
+			content_len = strtol(line + 15, NULL, 10);
+		else if (!strncasecmp(line, "Transfer-Encoding:", 18))
+			chunked = strcasestr(line + 18, "chunked") != NULL;
+		else if (!strncasecmp(line, "Connection:", 11))
+			keep = strcasestr(line + 11, "close") == NULL;
+	}
+
+	if (status != 200)
+		log_err_to(out0, "Open-Meteo: server answered with HTTP %d!\n",
+			status);
+
+	/* Body. */
+	if (chunked) {
+		for (total = 0;; total += chunk) {
+			if (om_line(om, &line) < 0)
+				log_err_to(out0, "Open-Meteo: unable to read chunk!\n");
+			chunk = strtoul(line, NULL, 16);
+			if (!chunk)
+				break;
+			if (chunk > OM_MAX_BODY - total)
+				log_err_to(out0, "Open-Meteo: answer too large!\n");
+			if (om_body(om, op, chunk) < 0 || om_line(om, &line) < 0)
+				log_err_to(out0, "Open-Meteo: unable to read answer!\n");
+		}
+		/* Trailers. */
+		n = 0;
+		do {
+			if (n++ == OM_MAX_HEADERS || om_line(om, &line) < 0)
+				log_err_to(out0, "Open-Meteo: unable to read answer!\n");
+		} while (line[0]);
+	}
+
+	else if (content_len >= 0) {
+		if (content_len > OM_MAX_BODY)
+			log_err_to(out0, "Open-Meteo: answer too large!\n");
+		if (om_body(om, op, content_len) < 0)
+			log_err_to(out0, "Open-Meteo: unable to read answer!\n");
+	}
+
+	/* Until the server closes the connection. */
+	else {
+		keep = 0;
+		for (total = 0; (r = om_take(om, OM_MAX_BODY, &p)) > 0; total += r)
+			if (total + r > OM_MAX_BODY ||
+			    json_feed(&op->jp, p, r) == JSON_ERROR)
+				break;
+		if (r != 0)
+			log_err_to(out0, "Open-Meteo: unable to read answer!\n");
+	}
+
+	if (!keep)
+		om_close(om);
+	return (0);
+out0:
+	return (-1);
+}
+
+/**
+ * @brief Parses the 'http://host[:port]' URL @p url.
+ *
+ * @param om  Provider context.
+ * @param url URL.
+ *
+ * @return Returns 0 if success, -1 otherwise.
+ */
+static int parse_url(struct openmeteo *om, const char *url)
+{
+	const char *host, *end, *colon;
+	size_t len;
+
+	if (strncmp(url, "http://", 7))
+		log_err_to(out0, "Open-Meteo: only http:// URLs are supported: %s\n",
+			url);
+
+	host  = url + 7;
+	end   = host + strcspn(host, "/");
+	colon = memchr(host, ':', end - host);
+
+	strcpy(om->port, "80");
+	if (colon) {
+		len = end - colon - 1;
+		if (!len || len >= sizeof(om->port))
+			log_err_to(out0, "Open-Meteo: invalid port: %s\n", url);
+		memcpy(om->port, colon + 1, len);
+		om->port[len] = '\0';
+		end = colon;
+	}
+
+	len = end - host;
+	if (!len || len >= sizeof(om->host))
+		log_err_to(out0, "Open-Meteo: invalid host: %s\n", url);
+	memcpy(om->host, host, len);
+	om->host[len] = '\0';
+	return (0);
+out0:
+	return (-1);
+}
+
+/**
+ * @brief Initializes the provider, see openmeteo.h.
+ *
+ * @param arg '<latitude>,<longitude>[,<location>]'.
+ * @param ctx Provider context.
+ *
+ * @return Returns 0 if success, -1 otherwise.
+ */
+static int om_init(const char *arg, void **ctx)
+{
+	struct openmeteo *om;
+	double lat, lon;
+	const char *url;
+	char query[256];
+	char *end;
+
+	if (!(om = calloc(1, sizeof(*om))))
+		log_oom("Unable to allocate Open-Meteo provider!\n");
+
+	om->fd = -1;
+
+	if (!arg)
+		log_err_to(out0, "Open-Meteo: <latitude>,<longitude> expected!\n");
+
+	lat = strtod(arg, &end);
+	if (end == arg || *end != ',' || lat < -90 || lat > 90)
+		log_err_to(out0, "Open-Meteo: invalid latitude: %s\n", arg);
+
+	arg = end + 1;
+	lon = strtod(arg, &end);
+	if (end == arg || (*end && *end != ',') || lon < -180 || lon > 180)
+		log_err_to(out0, "Open-Meteo: invalid longitude: %s\n", arg);
+
+	/* Location, defaults to the coordinates. */
+	if (*end == ',')
+		snprintf(om->location, sizeof(om->location), "%s", end + 1);
+	else
+		snprintf(om->location, sizeof(om->location), "%.2f, %.2f",
+			lat, lon);
+
+	url = getenv("WINDY_OPENMETEO_URL");
+	if (parse_url(om, url ? url : OPENMETEO_URL) < 0)
+		goto out0;
+
+	snprintf(query, sizeof(query), OM_QUERY, lat, lon);
+
+	snprintf(om->request, sizeof(om->request),
+		"GET %s HTTP/1.1\r\n"
+		"Host: %s%s%s\r\n"
+		"User-Agent: windy\r\n"
+		"Accept: application/json\r\n"
+		"Connection: keep-alive\r\n"
+		"\r\n",
+		query, om->host, strcmp(om->port, "80") ? ":" : "",
+		strcmp(om->port, "80") ? om->port : "");
+
+	log_info("Open-Meteo: using %s:%s for '%s'\n", om->host, om->port,
+		om->location);
+
+	*ctx = om;
+	return (0);
+out0:
+	free(om);
+	return (-1);
+}
+
+/**
+ * @brief Fetches the weather, see plugin.h.
+ *
+ * The connection is kept open between updates; if the
+ * server has closed it meanwhile, the request is retried
+ * once, on a new connection.
+ *
+ * @param ctx Provider context.
+ * @param wi  Weather info to be filled.
+ *
+ * @return Returns 0 if success, -1 otherwise.
+ */
+static int om_fetch(void *ctx, struct weather_info *wi)
+{
+	struct openmeteo *om;
+	struct om_parser op;
+	const char *cond;
+	int attempt;
+	int retry;
+	int i;
+
+	om = ctx;
+	om->deadline = om_now() + OM_DEADLINE * 1000LL;
+
+	for (attempt = 0; attempt < 2; attempt++) {
+		/* Fresh connections are not retried. */
+		if (om->fd < 0) {
+			if (om_connect(om) < 0)
+				return (-1);
+			attempt = 1;
+		}
+
+		memset(&op, 0, sizeof(op));
+		json_init(&op.jp, om_value, &op);
+
+		if (!om_exchange(om, &op, &retry))
+			break;
+
+		om_close(om);
+		if (!retry || attempt || !om_left(om))
+			return (-1);
+	}
+
+	if (json_finish(&op.jp) != JSON_DONE)
+		log_err_to(out0, "Open-Meteo: invalid json (byte %zu): %s!\n",
+			op.jp.pos, op.jp.error);
+
+	if ((op.seen & SEEN_ALL) != SEEN_ALL)
+		log_err_to(out0, "Open-Meteo: answer with missing values!\n");
+
+	/* Current weather, and today's max/min. */
+	if (!(cond = condition(op.code)))
+		log_err_to(out0, "Open-Meteo: unknown weather code: %d\n", op.code);
+
+	wi->temperature = om_round(op.temp);
+	wi->max_temp    = om_round(op.max[0]);
+	wi->min_temp    = om_round(op.min[0]);
+	strcpy(wi->condition, cond);
+	strcpy(wi->location, om->location);
+	strcpy(wi->provider, "OpenMeteo");
+
+	/* Next three days. */
+	for (i = 0; i < 3; i++) {
+		if (!(cond = condition(op.codes[i + 1])))
+			log_err_to(out0, "Open-Meteo: unknown weather code: %d\n",
+				op.codes[i + 1]);
+
+		wi->forecast[i].max_temp = om_round(op.max[i + 1]);
+		wi->forecast[i].min_temp = om_round(op.min[i + 1]);
+		strcpy(wi->forecast[i].condition, cond);
+	}
+	return (0);
+out0:
+	return (-1);
+}
+
+/**
+ * @brief Finishes the provider.
+ *
+ * @param ctx Provider context.
+ */
+static void om_quit(void *ctx)
+{
+	om_close(ctx);
+	free(ctx);
+}
+
+const struct windy_plugin openmeteo_plugin = {
+	.abi   = WINDY_PLUGIN_ABI,
+	.name  = "Open-Meteo (built-in)",
+	.init  = om_init,
+	.fetch = om_fetch,
+	.quit  = om_quit,
+};
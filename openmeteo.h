@@ -0,0 +1,46 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2026 Davidson Francis <davidsondfgl@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef OPENMETEO_H
+#define OPENMETEO_H
+
+	#include "plugin.h"
+
+	/*
+	 * Built-in Open-Meteo provider (-o), i.e., request.py
+	 * in C: same API call and same weathercode mapping,
+	 * but over a single HTTP/1.1 connection kept open
+	 * between updates, and filling the weather info
+	 * directly.
+	 *
+	 * Its argument is '<latitude>,<longitude>[,<location>]'.
+	 * The server defaults to OPENMETEO_URL, and can be
+	 * changed (e.g., for a local mock server) with the
+	 * environment variable WINDY_OPENMETEO_URL.
+	 */
+	#define OPENMETEO_URL "http://api.open-meteo.com"
+
+	extern const struct windy_plugin openmeteo_plugin;
+
+#endif /* OPENMETEO_H */
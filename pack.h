@@ -0,0 +1,93 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2026 Davidson Francis <davidsondfgl@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef PACK_H
+#define PACK_H
+
+	#include <stdint.h>
+
+	/*
+	 * Asset pack
+	 *
+	 * All images in assets/ are baked at build time (by
+	 * tools/mkpack) into a single file, already decoded,
+	 * with premultiplied alpha and in the pixel format
+	 * preferred by the renderers (ARGB8888), so they can
+	 * be uploaded as-is, without any decoding or conversion.
+	 *
+	 * Only the visible (non fully transparent) rectangle
+	 * of each image is stored, and its place in the texture
+	 * atlas is also computed at build time.
+	 *
+	 * Layout:
+	 *   struct pack_header
+	 *   struct pack_entry[count], sorted by name
+	 *   pixel data, each image aligned to PACK_ALIGN bytes
+	 *
+	 * All values are in host byte order, the pack is not
+	 * meant to be portable across machines, only to be
+	 * mapped by the windy binary built alongside it.
+	 */
+	#define PACK_FILE    "assets/assets.pack"
+	#define PACK_MAGIC   "WINDYPAK"
+	#define PACK_VERSION 2
+	#define PACK_ALIGN   64
+
+	/* Atlas width and spacing between images. */
+	#define PACK_ATLAS_WIDTH 1024
+	#define PACK_ATLAS_PAD      1
+
+	/* Maximum asset name size. */
+	#define PACK_NAME_MAX 64
+
+	/* Pixel formats. */
+	#define PACK_FORMAT_ARGB8888_PREMUL 1
+
+	struct pack_header
+	{
+		char magic[8];
+		uint32_t version;
+		uint32_t format;
+		uint32_t count;
+		uint32_t atlas_w;
+		uint32_t atlas_h;
+		uint32_t reserved;
+	};
+
+	struct pack_entry
+	{
+		char name[PACK_NAME_MAX];
+		uint32_t width;   /* Original image size.              */
+		uint32_t height;
+		uint32_t x;       /* Visible rectangle, i.e., what is  */
+		uint32_t y;       /* actually stored.                  */
+		uint32_t w;
+		uint32_t h;
+		uint32_t atlas_x; /* Position in the atlas.            */
+		uint32_t atlas_y;
+		uint32_t pitch;
+		uint32_t offset;  /* From the beginning of the pack.   */
+	};
+
+#endif /* PACK_H */
@@ -0,0 +1,64 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2026 Davidson Francis <davidsondfgl@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef PLUGIN_H
+#define PLUGIN_H
+
+	#include "weather.h"
+
+	/*
+	 * Provider plugin ABI
+	 *
+	 * A provider plugin is a shared object (loaded with
+	 * -p) that exports, under the name 'windy_plugin', a
+	 * struct windy_plugin. Its functions are called from
+	 * the worker thread only, so a plugin does not need to
+	 * be thread-safe, and it is free to keep connections
+	 * and caches between calls.
+	 *
+	 * - init(): called once, at startup, with the -c
+	 *   argument (or NULL). Returns 0 if success, and its
+	 *   private context in 'ctx'.
+	 *
+	 * - fetch(): fills the weather info pointed by 'wi'
+	 *   (already zeroed, see weather.h). Returns 0 if
+	 *   success, 1 if nothing changed since the last call
+	 *   (only 'next_update_in' is then considered), and -1
+	 *   if error.
+	 *
+	 * - quit(): called once, at exit (optional).
+	 */
+	#define WINDY_PLUGIN_ABI    1
+	#define WINDY_PLUGIN_SYMBOL "windy_plugin"
+
+	struct windy_plugin
+	{
+		int abi; /* WINDY_PLUGIN_ABI. */
+		const char *name;
+		int (*init)(const char *arg, void **ctx);
+		int (*fetch)(void *ctx, struct weather_info *wi);
+		void (*quit)(void *ctx);
+	};
+
+#endif /* PLUGIN_H */
@@ -0,0 +1,94 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2026 Davidson Francis <davidsondfgl@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*
+ * Example provider plugin: always shows the same weather,
+ * with the location given by -c, e.g.:
+ *   $ ./windy -p plugins/fixed.so -c "Tokyo, Japan"
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "plugin.h"
+
+struct fixed
+{
+	char location[WEATHER_STR_SIZE];
+	int calls;
+};
+
+static void copy(char *dst, size_t size, const char *src)
+{
+	snprintf(dst, size, "%s", src);
+}
+
+static int fixed_init(const char *arg, void **ctx)
+{
+	struct fixed *f;
+
+	if (!(f = calloc(1, sizeof(*f))))
+		return (-1);
+
+	copy(f->location, sizeof(f->location), arg ? arg : "Nowhere");
+	*ctx = f;
+	return (0);
+}
+
+static int fixed_fetch(void *ctx, struct weather_info *wi)
+{
+	static const struct forecast fc[3] = {
+		{27, 19, "clouds"},
+		{25, 18, "rainfall"},
+		{29, 20, "clear"},
+	};
+	struct fixed *f = ctx;
+
+	/* Same data as before, no need to send it again. */
+	if (f->calls++)
+		return (1);
+
+	wi->temperature = 24;
+	wi->max_temp    = 28;
+	wi->min_temp    = 19;
+	copy(wi->condition, sizeof(wi->condition), "clear");
+	copy(wi->location, sizeof(wi->location), f->location);
+	copy(wi->provider, sizeof(wi->provider), "Fixed plugin");
+	memcpy(wi->forecast, fc, sizeof(fc));
+	return (0);
+}
+
+static void fixed_quit(void *ctx)
+{
+	free(ctx);
+}
+
+const struct windy_plugin windy_plugin = {
+	.abi   = WINDY_PLUGIN_ABI,
+	.name  = "fixed",
+	.init  = fixed_init,
+	.fetch = fixed_fetch,
+	.quit  = fixed_quit,
+};
@@ -0,0 +1,1148 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2026 Davidson Francis <davidsondfgl@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#define _GNU_SOURCE /* SCHED_IDLE, execvpe(). */
+#include <dlfcn.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <poll.h>
+#include <sched.h>
+#include <signal.h>
+#include <spawn.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "provider.h"
+#include "plugin.h"
+#include "stats.h"
+#include "log.h"
+
+extern char **environ;
+
+/* Characters that, unquoted, need an actual shell. */
+#define SHELL_CHARS "|&;<>()$`*?[]{}~!#\n"
+
+/* ioprio_set(2) values, not exposed by libc. */
+#define IOPRIO_WHO_PROCESS 1
+#define IOPRIO_IDLE        (3 << 13)
+
+/* Previous answer hash, in the provider environment. */
+#define HASH_VAR     "WINDY_PREV_HASH="
+#define HASH_VAR_LEN (sizeof(HASH_VAR) - 1)
+
+/**
+ * @brief Creates a new pipe with both ends marked as
+ * close-on-exec, so that they do not leak into other
+ * children.
+ *
+ * @param fds Pipe file descriptors.
+ *
+ * @return Returns 0 if success, -1 otherwise.
+ */
+static int pipe_cloexec(int fds[2])
+{
+	if (pipe(fds) < 0)
+		return (-1);
+	fcntl(fds[0], F_SETFD, FD_CLOEXEC);
+	fcntl(fds[1], F_SETFD, FD_CLOEXEC);
+	return (0);
+}
+
+/**
+ * @brief Returns the current monotonic time, in ms.
+ */
+static long long now_ms(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (ts.tv_sec * 1000LL + ts.tv_nsec / 1000000);
+}
+
+/**
+ * @brief Reads up to @p size bytes of the provider output
+ * into @p buf, waiting (at most) until the deadline of
+ * the current request.
+ *
+ * @param p    Provider.
+ * @param buf  Destination buffer.
+ * @param size Buffer size.
+ *
+ * @return Returns the amount of bytes read, 0 if EOF,
+ * PROVIDER_ERR_TIMEOUT if the deadline expired, and -1
+ * if error.
+ */
+static ssize_t timed_read(struct provider *p, char *buf, size_t size)
+{
+	struct pollfd pfd;
+	long long left;
+	ssize_t ret;
+	int timeout;
+
+	pfd.fd     = p->out_fd;
+	pfd.events = POLLIN;
+
+	do {
+		timeout = -1;
+		if (p->lim.timeout_ms) {
+			left = p->deadline - now_ms();
+			if (left <= 0)
+				return (PROVIDER_ERR_TIMEOUT);
+			timeout = left > INT_MAX ? INT_MAX : (int)left;
+		}
+		ret = poll(&pfd, 1, timeout);
+	} while (ret == 0 || (ret < 0 && errno == EINTR));
+
+	if (ret < 0)
+		return (-1);
+
+	do {
+		ret = read(p->out_fd, buf, size);
+	} while (ret < 0 && errno == EINTR);
+	return (ret);
+}
+
+/**
+ * @brief Splits the command @p cmd into arguments, with
+ * shell-like quoting ('...', "..." and backslashes), so
+ * that it can be executed directly, without a shell.
+ *
+ * @param cmd Command to be split.
+ *
+ * @return Returns a NULL-terminated argument list (a
+ * single allocation), or NULL if the command is empty or
+ * needs an actual shell (e.g., pipes, redirections,
+ * variables, globs, assignments...).
+ */
+static char **cmd_split(const char *cmd)
+{
+	const char *s;
+	char **argv;
+	size_t len;
+	int in_word;
+	int argc;
+	char *d;
+
+	len  = strlen(cmd);
+	argv = malloc((len / 2 + 2) * sizeof(char *) + len + 1);
+	if (!argv)
+		return (NULL);
+
+	d       = (char *)(argv + len / 2 + 2);
+	argc    = 0;
+	in_word = 0;
+
+	for (s = cmd; *s; s++) {
+		if (*s == ' ' || *s == '\t') {
+			if (in_word)
+				*d++ = '\0';
+			in_word = 0;
+			continue;
+		}
+
+		if (!in_word) {
+			argv[argc++] = d;
+			in_word = 1;
+		}
+
+		/* 'Everything is literal'. */
+		if (*s == '\'') {
+			for (s++; *s && *s != '\''; s++)
+				*d++ = *s;
+			if (!*s)
+				goto shell;
+		}
+
+		/* "Almost everything is literal". */
+		else if (*s == '"') {
+			for (s++; *s && *s != '"'; s++) {
+				if (*s == '$' || *s == '`')
+					goto shell;
+				if (*s == '\\' && s[1] && strchr("\"\\", s[1]))
+					s++;
+				*d++ = *s;
+			}
+			if (!*s)
+				goto shell;
+		}
+
+		else if (*s == '\\') {
+			if (!*++s || *s == '\n')
+				goto shell;
+			*d++ = *s;
+		}
+
+		/* VAR=value prefix. */
+		else if (strchr(SHELL_CHARS, *s) || (*s == '=' && argc == 1))
+			goto shell;
+
+		else
+			*d++ = *s;
+	}
+
+	*d = '\0';
+	if (!argc)
+		goto shell;
+
+	argv[argc] = NULL;
+	return (argv);
+shell:
+	free(argv);
+	return (NULL);
+}
+
+/**
+ * @brief Builds the provider environment: ours, plus
+ * the hash of the last valid answer (WINDY_PREV_HASH),
+ * if any.
+ *
+ * @param p   Provider.
+ * @param var Buffer for the hash variable, of at least
+ *            HASH_VAR_LEN + PROVIDER_HASH_SIZE bytes.
+ *
+ * @return Returns the new environment, to be freed by
+ * the caller, or NULL if the current one should be used
+ * as is.
+ */
+static char **spawn_env(const struct provider *p, char *var)
+{
+	char **envp;
+	size_t n, i;
+
+	if (!p->hash[0])
+		return (NULL);
+
+	for (n = 0; environ[n]; n++);
+	if (!(envp = malloc((n + 2) * sizeof(char *))))
+		return (NULL);
+
+	for (i = 0, n = 0; environ[i]; i++)
+		if (strncmp(environ[i], HASH_VAR, HASH_VAR_LEN))
+			envp[n++] = environ[i];
+
+	memcpy(var, HASH_VAR, HASH_VAR_LEN);
+	memcpy(var + HASH_VAR_LEN, p->hash, PROVIDER_HASH_SIZE);
+	envp[n++] = var;
+	envp[n]   = NULL;
+	return (envp);
+}
+
+/* Limits that could not be applied, see apply_limits(). */
+#define LIMIT_NICE    (1 << 0)
+#define LIMIT_IDLE    (1 << 1)
+#define LIMIT_IO_IDLE (1 << 2)
+#define LIMIT_AS      (1 << 3)
+#define LIMIT_CPU     (1 << 4)
+
+/**
+ * @brief Checks if the provider @p p has any resource
+ * limit at all.
+ */
+static int has_limits(const struct provider *p)
+{
+	return (p->lim.nice || p->lim.idle || p->lim.max_as ||
+		p->lim.max_cpu);
+}
+
+/**
+ * @brief Applies the resource limits of the provider @p p
+ * to the calling process, i.e., the provider itself, in
+ * the child, before exec: so nothing it runs (not even
+ * what /bin/sh forks) escapes them.
+ *
+ * Only async-signal-safe calls here.
+ *
+ * @param p    Provider.
+ * @param nice Nice value to be set.
+ *
+ * @return Returns the limits that could not be applied
+ * (LIMIT_*), if any, 0 otherwise.
+ */
+static int apply_limits(const struct provider *p, int nice)
+{
+	struct sched_param sp;
+	struct rlimit rl;
+	int failed;
+
+	failed = 0;
+	if (p->lim.nice && setpriority(PRIO_PROCESS, 0, nice) < 0)
+		failed |= LIMIT_NICE;
+
+	sp.sched_priority = 0;
+	if (p->lim.idle && sched_setscheduler(0, SCHED_IDLE, &sp) < 0)
+		failed |= LIMIT_IDLE;
+
+#ifdef SYS_ioprio_set
+	if (p->lim.idle &&
+		syscall(SYS_ioprio_set, IOPRIO_WHO_PROCESS, 0, IOPRIO_IDLE) < 0)
+	{
+		failed |= LIMIT_IO_IDLE;
+	}
+#endif
+
+	if (p->lim.max_as) {
+		rl.rlim_cur = rl.rlim_max = p->lim.max_as;
+		if (setrlimit(RLIMIT_AS, &rl) < 0)
+			failed |= LIMIT_AS;
+	}
+
+	if (p->lim.max_cpu) {
+		rl.rlim_cur = rl.rlim_max = p->lim.max_cpu;
+		if (setrlimit(RLIMIT_CPU, &rl) < 0)
+			failed |= LIMIT_CPU;
+	}
+	return (failed);
+}
+
+/**
+ * @brief Logs the limits in @p failed, that could not
+ * be applied to the provider.
+ */
+static void log_limits(int failed)
+{
+	if (failed & LIMIT_NICE)
+		log_info("Unable to set provider priority!\n");
+	if (failed & LIMIT_IDLE)
+		log_info("Unable to set provider CPU priority!\n");
+	if (failed & LIMIT_IO_IDLE)
+		log_info("Unable to set provider I/O priority!\n");
+	if (failed & LIMIT_AS)
+		log_info("Unable to limit provider memory!\n");
+	if (failed & LIMIT_CPU)
+		log_info("Unable to limit provider CPU time!\n");
+}
+
+/**
+ * @brief Logs and accounts the resources used by the
+ * provider process @p pid, just reaped.
+ *
+ * @param pid Provider process.
+ * @param ru  Its resource usage, as given by wait4().
+ */
+static void log_usage(pid_t pid, const struct rusage *ru)
+{
+	long long utime, stime;
+
+	utime = ru->ru_utime.tv_sec * 1000000LL + ru->ru_utime.tv_usec;
+	stime = ru->ru_stime.tv_sec * 1000000LL + ru->ru_stime.tv_usec;
+
+	log_info("Provider (pid: %d) used %.3f s user, %.3f s sys, "
+		"%ld KiB max RSS\n", (int)pid, utime / 1e6, stime / 1e6,
+		ru->ru_maxrss);
+
+	stats_add(STATS_PROVIDER_USER_US, utime);
+	stats_add(STATS_PROVIDER_SYS_US, stime);
+	stats_set(STATS_PROVIDER_MAXRSS_KB, ru->ru_maxrss);
+}
+
+/**
+ * @brief Starts the provider command with resource limits,
+ * applied in the child before exec (see apply_limits()),
+ * which posix_spawn() has no way to do.
+ *
+ * The child reports back (through a close-on-exec pipe)
+ * the limits that failed, and then the exec error, if
+ * any.
+ *
+ * @param p      Provider.
+ * @param in_fd  Child stdin, or -1 to keep ours.
+ * @param out_fd Child stdout.
+ * @param envp   Child environment.
+ *
+ * @return Returns the child pid, or -1 if error.
+ */
+static pid_t spawn_limited(struct provider *p, int in_fd, int out_fd,
+	char **envp)
+{
+	char *sh_argv[] = {"sh", "-c", (char *)p->command, NULL};
+	int msg[2];
+	int fds[2];
+	ssize_t r, n;
+	int nice;
+	pid_t pid;
+	int err;
+
+	if (pipe_cloexec(fds) < 0)
+		return (-1);
+
+	nice = getpriority(PRIO_PROCESS, 0) + p->lim.nice;
+
+	pid = fork();
+	if (pid < 0) {
+		err = errno;
+		goto out;
+	}
+
+	/* Child. */
+	if (!pid) {
+		if ((in_fd >= 0 && dup2(in_fd, STDIN_FILENO) < 0) ||
+			dup2(out_fd, STDOUT_FILENO) < 0)
+		{
+			_exit(127);
+		}
+
+		msg[0] = apply_limits(p, nice);
+		write(fds[1], &msg[0], sizeof(int));
+
+		/* Not a program (e.g., a shell builtin): the shell
+		 * knows better. */
+		if (p->argv)
+			execvpe(p->argv[0], p->argv, envp);
+		if (!p->argv || errno == ENOENT)
+			execve("/bin/sh", sh_argv, envp);
+
+		msg[1] = errno;
+		write(fds[1], &msg[1], sizeof(int));
+		_exit(127);
+	}
+
+	/* Parent: wait for the exec (or its error). */
+	close(fds[1]);
+	fds[1] = -1;
+
+	err = 0;
+	for (r = 0; r < (ssize_t)sizeof(msg); r += n) {
+		n = read(fds[0], (char *)msg + r, sizeof(msg) - r);
+		if (n < 0 && errno == EINTR) {
+			n = 0;
+			continue;
+		}
+		if (n <= 0)
+			break;
+	}
+
+	if (r >= (ssize_t)sizeof(int))
+		log_limits(msg[0]);
+	if (r == (ssize_t)sizeof(msg)) {
+		err = msg[1];
+		waitpid(pid, NULL, 0);
+	}
+out:
+	close(fds[0]);
+	if (fds[1] >= 0)
+		close(fds[1]);
+	if (err) {
+		errno = err;
+		return (-1);
+	}
+	return (pid);
+}
+
+/**
+ * @brief Starts the provider command, with its stdout
+ * (and stdin, if @p in_fd is not -1) redirected.
+ *
+ * Simple commands are executed directly (via posix_spawn,
+ * i.e., vfork semantics), anything else goes through
+ * /bin/sh. If there are resource limits, the command is
+ * started with spawn_limited() instead.
+ *
+ * @param p      Provider.
+ * @param in_fd  Child stdin, or -1 to keep ours.
+ * @param out_fd Child stdout.
+ * @param envp   Child environment.
+ *
+ * @return Returns the child pid, or -1 if error.
+ */
+static pid_t spawn(struct provider *p, int in_fd, int out_fd, char **envp)
+{
+	char *sh_argv[] = {"sh", "-c", (char *)p->command, NULL};
+	posix_spawn_file_actions_t fa;
+	pid_t pid;
+	int err;
+
+	if (has_limits(p))
+		return (spawn_limited(p, in_fd, out_fd, envp));
+
+	if (posix_spawn_file_actions_init(&fa))
+		return (-1);
+
+	err = 0;
+	if (in_fd >= 0)
+		err = posix_spawn_file_actions_adddup2(&fa, in_fd, STDIN_FILENO);
+	if (!err)
+		err = posix_spawn_file_actions_adddup2(&fa, out_fd, STDOUT_FILENO);
+	if (err)
+		goto out;
+
+	if (p->argv) {
+		err = posix_spawnp(&pid, p->argv[0], &fa, NULL, p->argv, envp);
+
+		/* Not a program (e.g., a shell builtin): the shell
+		 * knows better. */
+		if (err != ENOENT)
+			goto out;
+	}
+
+	err = posix_spawn(&pid, "/bin/sh", &fa, NULL, sh_argv, envp);
+out:
+	posix_spawn_file_actions_destroy(&fa);
+	if (err) {
+		errno = err;
+		return (-1);
+	}
+	return (pid);
+}
+
+/**
+ * @brief Starts the persistent provider process, with
+ * its stdin and stdout connected to pipes.
+ *
+ * @param p Provider.
+ *
+ * @return Returns 0 if success, -1 otherwise.
+ */
+static int coproc_spawn(struct provider *p)
+{
+	int in[2], out[2];
+	pid_t pid;
+
+	if (pipe_cloexec(in) < 0)
+		log_err_to(out0, "Unable to create provider pipe!\n");
+	if (pipe_cloexec(out) < 0)
+		log_err_to(out1, "Unable to create provider pipe!\n");
+
+	pid = spawn(p, in[0], out[1], environ);
+	if (pid < 0)
+		log_err_to(out2, "Unable to start provider: %s\n", strerror(errno));
+
+	close(in[0]);
+	close(out[1]);
+	p->pid    = pid;
+	p->in_fd  = in[1];
+	p->out_fd = out[0];
+	log_info("Provider started (pid: %d)\n", (int)pid);
+	return (0);
+
+out2:
+	close(out[0]);
+	close(out[1]);
+out1:
+	close(in[0]);
+	close(in[1]);
+out0:
+	return (-1);
+}
+
+/**
+ * @brief Closes the persistent provider pipes and
+ * reaps the process.
+ *
+ * Closing its stdin should be enough for a well-behaved
+ * provider to exit, if not, it is killed.
+ *
+ * @param p Provider.
+ */
+static void coproc_reap(struct provider *p)
+{
+	struct rusage ru;
+	pid_t ret;
+	int status;
+	int i;
+
+	if (p->pid <= 0)
+		return;
+
+	close(p->in_fd);
+	close(p->out_fd);
+	p->in_fd  = -1;
+	p->out_fd = -1;
+
+	/* Give it ~100ms to finish by itself. */
+	for (i = 0; i < 10; i++) {
+		if ((ret = wait4(p->pid, &status, WNOHANG, &ru)) != 0)
+			goto out;
+		usleep(10*1000);
+	}
+
+	kill(p->pid, SIGKILL);
+	ret = wait4(p->pid, &status, 0, &ru);
+out:
+	log_info("Provider (pid: %d) finished\n", (int)p->pid);
+	if (ret > 0)
+		log_usage(p->pid, &ru);
+	p->pid = -1;
+}
+
+/**
+ * @brief Discards anything the persistent provider might
+ * have written outside of a request, so that it is not
+ * mistaken as the next answer.
+ *
+ * @param p Provider.
+ */
+static void coproc_drain(struct provider *p)
+{
+	struct pollfd pfd;
+	char tmp[256];
+
+	pfd.fd     = p->out_fd;
+	pfd.events = POLLIN;
+	while (poll(&pfd, 1, 0) > 0 && (pfd.revents & POLLIN)) {
+		if (read(p->out_fd, tmp, sizeof tmp) <= 0)
+			break;
+	}
+}
+
+/**
+ * @brief Asks the persistent provider for a new weather
+ * json, starting it if not running.
+ *
+ * The request line holds the hash of the last valid
+ * answer, if any.
+ *
+ * @param p Provider.
+ *
+ * @return Returns 0 if success, -1 otherwise.
+ */
+static int coproc_request(struct provider *p)
+{
+	char line[PROVIDER_HASH_SIZE + 1];
+	ssize_t ret;
+	size_t len;
+
+	if (p->pid <= 0 && coproc_spawn(p) < 0)
+		return (-1);
+
+	coproc_drain(p);
+
+	len = strlen(p->hash);
+	memcpy(line, p->hash, len);
+	line[len++] = '\n';
+
+	do {
+		ret = write(p->in_fd, line, len);
+	} while (ret < 0 && errno == EINTR);
+
+	/* Provider died, restart it. */
+	if (ret != (ssize_t)len) {
+		coproc_reap(p);
+		if (coproc_spawn(p) < 0)
+			return (-1);
+		if (write(p->in_fd, line, len) != (ssize_t)len)
+			log_err_to(out0, "Unable to write to provider!\n");
+	}
+
+	return (0);
+out0:
+	coproc_reap(p);
+	return (-1);
+}
+
+/**
+ * @brief Reads a single line of the persistent provider.
+ *
+ * If the provider dies before answering anything, it is
+ * restarted and asked again (only once).
+ *
+ * @param p    Provider.
+ * @param buf  Destination buffer.
+ * @param size Buffer size.
+ *
+ * @return Returns the amount of bytes read, 0 if the
+ * line is over, and -1 if error.
+ */
+static ssize_t coproc_read(struct provider *p, char *buf, size_t size)
+{
+	ssize_t ret;
+	char *nl;
+
+	if (p->done)
+		return (0);
+
+again:
+	ret = timed_read(p, buf, size);
+	if (ret <= 0) {
+		coproc_reap(p);
+		if (!p->restarted && !ret) {
+			p->restarted = 1;
+			log_info("Provider exited without answering, restarting...\n");
+			if (coproc_request(p) < 0)
+				return (-1);
+			goto again;
+		}
+		return (ret);
+	}
+
+	/*
+	 * Once the provider starts answering, a restart would
+	 * mix two different answers, so do not allow it.
+	 */
+	p->restarted = 1;
+
+	/* Anything after the line ending is not ours. */
+	if ((nl = memchr(buf, '\n', ret))) {
+		p->done = 1;
+		ret = nl - buf;
+	}
+	return (ret);
+}
+
+/**
+ * @brief Initializes the provider @p p.
+ *
+ * @param p          Provider to be initialized.
+ * @param command    Command to be executed.
+ * @param persistent If non-zero, run the command as a
+ *                   co-process, instead of executing it
+ *                   on every update.
+ * @param lim        Provider limits.
+ */
+void provider_init(struct provider *p, const char *command,
+	int persistent, const struct provider_limits *lim)
+{
+	memset(p, 0, sizeof(*p));
+	p->command    = command;
+	p->persistent = persistent;
+	p->lim        = *lim;
+	p->pid        = -1;
+	p->in_fd      = -1;
+	p->out_fd     = -1;
+
+	/* Parsed only once, for all updates. */
+	p->argv = cmd_split(command);
+	log_info("Provider command runs %s\n",
+		p->argv ? "directly" : "through /bin/sh");
+
+	/*
+	 * A provider that dies between updates should not
+	 * kill us as well when we write into its stdin.
+	 */
+	if (persistent)
+		signal(SIGPIPE, SIG_IGN);
+}
+
+/**
+ * @brief Initializes the provider @p p to call the plugin
+ * function table @p plugin.
+ *
+ * @param p      Provider to be initialized.
+ * @param plugin Plugin function table.
+ * @param name   Plugin name, for logging.
+ * @param arg    Plugin argument, may be NULL.
+ */
+static void plugin_setup(struct provider *p,
+	const struct windy_plugin *plugin, const char *name, const char *arg)
+{
+	if (plugin->abi != WINDY_PLUGIN_ABI || !plugin->fetch)
+		log_panic("Plugin (%s) ABI mismatch, expected %d, got %d!\n",
+			name, WINDY_PLUGIN_ABI, plugin->abi);
+
+	if (plugin->init && plugin->init(arg, &p->plugin_ctx) < 0)
+		log_panic("Unable to initialize plugin (%s)!\n", name);
+
+	p->plugin = plugin;
+	log_info("Provider plugin '%s' loaded\n",
+		plugin->name ? plugin->name : name);
+}
+
+/**
+ * @brief Initializes the provider @p p from the plugin
+ * at @p path (see plugin.h).
+ *
+ * As with the command, a plugin that cannot be loaded
+ * is a fatal error.
+ *
+ * @param p    Provider to be initialized.
+ * @param path Plugin (shared object) path.
+ * @param arg  Plugin argument, may be NULL.
+ */
+void provider_init_plugin(struct provider *p, const char *path,
+	const char *arg)
+{
+	const struct windy_plugin *plugin;
+
+	memset(p, 0, sizeof(*p));
+	p->pid    = -1;
+	p->in_fd  = -1;
+	p->out_fd = -1;
+
+	p->dl = dlopen(path, RTLD_NOW|RTLD_LOCAL);
+	if (!p->dl)
+		log_panic("Unable to load plugin: %s\n", dlerror());
+
+	plugin = dlsym(p->dl, WINDY_PLUGIN_SYMBOL);
+	if (!plugin)
+		log_panic("Plugin (%s) does not export '%s'!\n", path,
+			WINDY_PLUGIN_SYMBOL);
+
+	plugin_setup(p, plugin, path, arg);
+}
+
+/**
+ * @brief Initializes the provider @p p with a built-in
+ * plugin, i.e., linked into windy.
+ *
+ * @param p      Provider to be initialized.
+ * @param plugin Plugin function table.
+ * @param arg    Plugin argument, may be NULL.
+ */
+void provider_init_builtin(struct provider *p,
+	const struct windy_plugin *plugin, const char *arg)
+{
+	memset(p, 0, sizeof(*p));
+	p->pid    = -1;
+	p->in_fd  = -1;
+	p->out_fd = -1;
+	plugin_setup(p, plugin, plugin->name, arg);
+}
+
+/**
+ * @brief Asks the provider plugin for new weather info.
+ *
+ * @param p  Provider, initialized with provider_init_plugin().
+ * @param wi Weather info to be filled.
+ *
+ * @return Returns 0 if success, 1 if nothing changed, and
+ * -1 if error.
+ */
+int provider_fetch(struct provider *p, struct weather_info *wi)
+{
+	return (p->plugin->fetch(p->plugin_ctx, wi));
+}
+
+/**
+ * @brief Starts a new provider request, i.e., executes
+ * the command (one-shot) or asks the running co-process
+ * for a new json.
+ *
+ * @param p Provider.
+ *
+ * @return Returns 0 if success, -1 otherwise.
+ */
+int provider_begin(struct provider *p)
+{
+	char var[HASH_VAR_LEN + PROVIDER_HASH_SIZE];
+	char **envp;
+	int out[2];
+	pid_t pid;
+
+	p->started  = now_ms();
+	p->deadline = p->started + p->lim.timeout_ms;
+	p->nread    = 0;
+
+	if (!p->persistent) {
+		if (pipe_cloexec(out) < 0)
+			return (-1);
+
+		envp = spawn_env(p, var);
+		pid  = spawn(p, -1, out[1], envp ? envp : environ);
+		free(envp);
+		close(out[1]);
+
+		if (pid < 0) {
+			close(out[0]);
+			log_err_to(out0, "Unable to start provider: %s\n", strerror(errno));
+		}
+
+		p->pid    = pid;
+		p->out_fd = out[0];
+		return (0);
+	}
+
+	p->done      = 0;
+	p->restarted = 0;
+	return (coproc_request(p));
+out0:
+	return (-1);
+}
+
+/**
+ * @brief Reads up to @p size bytes of the current
+ * provider answer into @p buf.
+ *
+ * If the provider takes too long or outputs too much
+ * (see struct provider_limits), it is killed.
+ *
+ * @param p    Provider.
+ * @param buf  Destination buffer.
+ * @param size Buffer size.
+ *
+ * @return Returns the amount of bytes read, 0 if the
+ * answer is over, PROVIDER_ERR_TIMEOUT or
+ * PROVIDER_ERR_TOO_LARGE if a limit was exceeded, and
+ * -1 if error.
+ */
+ssize_t provider_read(struct provider *p, char *buf, size_t size)
+{
+	ssize_t ret;
+
+	if (p->persistent)
+		ret = coproc_read(p, buf, size);
+	else
+		ret = timed_read(p, buf, size);
+
+	if (ret > 0) {
+		p->nread += ret;
+		if (p->lim.max_output && p->nread > p->lim.max_output)
+			ret = PROVIDER_ERR_TOO_LARGE;
+	}
+
+	if (ret != PROVIDER_ERR_TIMEOUT && ret != PROVIDER_ERR_TOO_LARGE)
+		return (ret);
+
+	/* Reaped on provider_end() (one-shot) or right away. */
+	if (!p->persistent)
+		kill(p->pid, SIGKILL);
+	else {
+		coproc_reap(p);
+		p->done = 1;
+	}
+	return (ret);
+}
+
+/**
+ * @brief Finishes the current provider request, reaping
+ * the provider.
+ *
+ * The provider might keep running after its answer (or
+ * leave a child holding its stdout), so it is only waited
+ * for until its deadline, and then killed.
+ *
+ * @param p Provider.
+ *
+ * @return Returns 0 if success, 1 if the provider exited
+ * with PROVIDER_EXIT_UNCHANGED, PROVIDER_ERR_TIMEOUT if
+ * it had to be killed, -1 otherwise.
+ */
+int provider_end(struct provider *p)
+{
+	struct rusage ru;
+	int timeout;
+	int status;
+	pid_t ret;
+
+	if (p->persistent)
+		return (0);
+
+	close(p->out_fd);
+	p->out_fd = -1;
+
+	timeout = 0;
+	if (p->lim.timeout_ms) {
+		while ((ret = wait4(p->pid, &status, WNOHANG, &ru)) == 0 &&
+			now_ms() < p->deadline)
+		{
+			usleep(5*1000);
+		}
+		if (!ret) {
+			kill(p->pid, SIGKILL);
+			timeout = 1;
+		}
+	}
+
+	if (!p->lim.timeout_ms || timeout) {
+		do {
+			ret = wait4(p->pid, &status, 0, &ru);
+		} while (ret < 0 && errno == EINTR);
+	}
+
+	if (ret > 0)
+		log_usage(p->pid, &ru);
+
+	p->pid = -1;
+	if (timeout)
+		return (PROVIDER_ERR_TIMEOUT);
+	if (ret < 0)
+		return (-1);
+	if (WIFEXITED(status) && WEXITSTATUS(status) == PROVIDER_EXIT_UNCHANGED)
+		return (1);
+	return (0);
+}
+
+/**
+ * @brief Cancels the current provider request, killing
+ * the provider.
+ *
+ * @param p Provider.
+ */
+void provider_cancel(struct provider *p)
+{
+	if (p->persistent) {
+		coproc_reap(p);
+		p->done = 1;
+		return;
+	}
+	kill(p->pid, SIGKILL);
+	provider_end(p);
+}
+
+/**
+ * @brief Waits until one of the providers @p ps (all with
+ * a request in progress) has something to be read, or
+ * has run out of time.
+ *
+ * @param ps         Providers.
+ * @param n          Amount of providers, up to PROVIDER_MAX.
+ * @param timeout_ms Maximum time to wait, -1 for no limit.
+ *
+ * @return Returns the index of the provider that needs
+ * provider_read(), or -1 if @p timeout_ms expired (or
+ * error).
+ */
+int provider_wait(struct provider *const *ps, int n, int timeout_ms)
+{
+	struct pollfd pfds[PROVIDER_MAX];
+	long long now, end, left;
+	int timeout;
+	int ret;
+	int i;
+
+	end = now_ms() + timeout_ms;
+
+	while (1)
+	{
+		now     = now_ms();
+		timeout = -1;
+
+		if (timeout_ms >= 0) {
+			if (now >= end)
+				return (-1);
+			timeout = (int)(end - now);
+		}
+
+		for (i = 0; i < n; i++) {
+			pfds[i].fd     = ps[i]->out_fd;
+			pfds[i].events = POLLIN;
+
+			/* Co-process line already read. */
+			if (ps[i]->persistent && ps[i]->done)
+				return (i);
+
+			/* Let provider_read() handle the timeout. */
+			if (!ps[i]->lim.timeout_ms)
+				continue;
+			left = ps[i]->deadline - now;
+			if (left <= 0)
+				return (i);
+			if (timeout < 0 || left < timeout)
+				timeout = (int)left;
+		}
+
+		ret = poll(pfds, n, timeout);
+		if (ret < 0 && errno != EINTR)
+			return (-1);
+
+		for (i = 0; ret > 0 && i < n; i++)
+			if (pfds[i].revents)
+				return (i);
+	}
+}
+
+/**
+ * @brief Accounts the current provider request, finished
+ * with success (@p ok) or not, for provider_budget().
+ *
+ * @param p  Provider.
+ * @param ok 1 if the provider gave a valid answer, 0
+ *           otherwise.
+ */
+void provider_account(struct provider *p, int ok)
+{
+	unsigned lat;
+
+	lat = (unsigned)(now_ms() - p->started);
+	p->lat_last_ms = lat;
+
+	/* Moving averages, of the last ~4 requests. */
+	if (!p->samples)
+		p->ok_rate = 1000;
+	p->ok_rate = (3 * p->ok_rate + (ok ? 1000 : 0)) / 4;
+
+	if (ok)
+		p->lat_ms = p->lat_ms ? (3 * p->lat_ms + lat) / 4 : lat;
+
+	p->samples++;
+}
+
+/**
+ * @brief Returns how long to wait for the provider @p p
+ * before starting the next one as well.
+ *
+ * That is 'hedge_ms' for a new provider, twice its usual
+ * latency for one that usually answers faster, and none
+ * for one that usually fails.
+ *
+ * @param p Provider.
+ *
+ * @return Returns the budget, in ms.
+ */
+unsigned provider_budget(const struct provider *p)
+{
+	unsigned budget;
+
+	budget = p->lim.hedge_ms;
+	if (!p->samples)
+		return (budget);
+
+	if (p->ok_rate < 500)
+		return (0);
+
+	if (p->lat_ms && 2 * p->lat_ms < budget) {
+		budget = 2 * p->lat_ms;
+		if (budget < PROVIDER_HEDGE_MIN_MS)
+			budget = PROVIDER_HEDGE_MIN_MS;
+	}
+	return (budget);
+}
+
+/**
+ * @brief Sets the hash of the last valid answer, to be
+ * passed to the provider on the next requests.
+ *
+ * @param p    Provider.
+ * @param hash Answer hash.
+ */
+void provider_set_hash(struct provider *p, uint64_t hash)
+{
+	snprintf(p->hash, sizeof(p->hash), "%016llx", (unsigned long long)hash);
+}
+
+/**
+ * @brief Finishes the provider, stopping the
+ * co-process or unloading the plugin, if any.
+ *
+ * @param p Provider.
+ */
+void provider_quit(struct provider *p)
+{
+	if (p->plugin) {
+		if (p->plugin->quit)
+			p->plugin->quit(p->plugin_ctx);
+		if (p->dl)
+			dlclose(p->dl);
+		p->plugin = NULL;
+		p->dl     = NULL;
+	}
+	if (p->persistent)
+		coproc_reap(p);
+	free(p->argv);
+	p->argv = NULL;
+}
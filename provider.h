@@ -0,0 +1,149 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2026 Davidson Francis <davidsondfgl@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef PROVIDER_H
+#define PROVIDER_H
+
+	#include <stdint.h>
+	#include <sys/types.h>
+
+	/*
+	 * Weather provider, i.e., the external command
+	 * that outputs the weather json.
+	 *
+	 * The command is executed directly (i.e., without
+	 * a shell) if it is simple enough: a program and its
+	 * arguments, with shell-like quoting. Otherwise (pipes,
+	 * variables, redirections...), /bin/sh runs it.
+	 *
+	 * In 'one-shot' mode, the command is executed on
+	 * every update and its whole output is read until
+	 * EOF.
+	 *
+	 * In 'persistent' (co-process) mode, the command is
+	 * started only once, and for each update, a newline
+	 * is written to its stdin, and a single line (i.e.,
+	 * a newline-delimited json document) is read from
+	 * its stdout. If the command dies, it is restarted
+	 * on the next update.
+	 *
+	 * In both modes, the hash of the last valid answer
+	 * (see weather.c) is passed along: in the environment
+	 * variable WINDY_PREV_HASH (one-shot) or as the request
+	 * line itself (persistent). If nothing changed since
+	 * then, the provider can answer {"unchanged":true}
+	 * or (one-shot only) exit with PROVIDER_EXIT_UNCHANGED.
+	 *
+	 * Alternatively, the provider can be a plugin (see
+	 * plugin.h), i.e., a shared object loaded at startup
+	 * and called in-process: no processes, pipes or json
+	 * parsing, at the cost of none of the limits below
+	 * being applied.
+	 */
+	#define PROVIDER_EXIT_UNCHANGED 100
+	#define PROVIDER_HASH_SIZE       17
+
+	/*
+	 * Up to PROVIDER_MAX commands can be given, in priority
+	 * order: if a provider does not answer within its budget
+	 * (at most 'hedge_ms', less for providers that usually
+	 * answer faster), the next one is started as well, and
+	 * the first valid answer wins (see weather_get_any()).
+	 */
+	#define PROVIDER_MAX           4
+	#define PROVIDER_HEDGE_MIN_MS 100
+
+	/* provider_read() errors, besides -1. */
+	#define PROVIDER_ERR_TIMEOUT   -2
+	#define PROVIDER_ERR_TOO_LARGE -3
+
+	/*
+	 * Provider limits, for each request: if the answer
+	 * takes longer than 'timeout_ms', or is bigger than
+	 * 'max_output' bytes, the provider is killed. The
+	 * provider process also runs with a lower priority
+	 * ('nice' increment and/or 'idle' CPU/IO scheduling),
+	 * and address space and CPU time limits. 0 means no
+	 * limit.
+	 */
+	struct provider_limits
+	{
+		unsigned timeout_ms;
+		size_t max_output;
+		int nice;
+		int idle;
+		unsigned long max_as;  /* Bytes.   */
+		unsigned long max_cpu; /* Seconds. */
+		unsigned hedge_ms;
+	};
+	struct windy_plugin;
+	struct weather_info;
+
+	struct provider
+	{
+		const char *command;
+		char **argv;   /* Parsed command, NULL if shell. */
+		int persistent;
+		char hash[PROVIDER_HASH_SIZE];
+		struct provider_limits lim;
+		long long started;  /* Current request, in ms. */
+		long long deadline;
+		size_t nread;
+		pid_t pid;
+		int out_fd;
+		/* Persistent mode. */
+		int in_fd;
+		int done;
+		int restarted;
+		/* Answers so far, see provider_account(). */
+		unsigned lat_ms;      /* Average latency.   */
+		unsigned lat_last_ms;
+		unsigned ok_rate;     /* Per mille.         */
+		unsigned samples;
+		/* Plugin mode. */
+		const struct windy_plugin *plugin;
+		void *plugin_ctx;
+		void *dl;
+	};
+
+	extern void provider_init(struct provider *p, const char *command,
+		int persistent, const struct provider_limits *lim);
+	extern void provider_init_plugin(struct provider *p, const char *path,
+		const char *arg);
+	extern void provider_init_builtin(struct provider *p,
+		const struct windy_plugin *plugin, const char *arg);
+	extern int provider_fetch(struct provider *p, struct weather_info *wi);
+	extern int provider_begin(struct provider *p);
+	extern ssize_t provider_read(struct provider *p, char *buf,
+		size_t size);
+	extern int provider_end(struct provider *p);
+	extern void provider_cancel(struct provider *p);
+	extern int provider_wait(struct provider *const *ps, int n,
+		int timeout_ms);
+	extern void provider_account(struct provider *p, int ok);
+	extern unsigned provider_budget(const struct provider *p);
+	extern void provider_set_hash(struct provider *p, uint64_t hash);
+	extern void provider_quit(struct provider *p);
+
+#endif /* PROVIDER_H */
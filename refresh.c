@@ -0,0 +1,287 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2026 Davidson Francis <davidsondfgl@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <SDL3/SDL.h>
+
+#include "refresh.h"
+#include "log.h"
+
+/*
+ * Refresh scheduler
+ *
+ * Weather updates happen at wall-clock boundaries, i.e.,
+ * at multiples of the update interval since the epoch
+ * (for 10 minutes: at :00, :10, :20...), so the schedule
+ * does not drift with the time each update takes.
+ *
+ * There is no timer thread: the main loop just waits
+ * for events up to the next deadline, see refresh_timeout().
+ * Deadlines are kept in both the monotonic clock (so wall
+ * clock adjustments do not matter) and the wall clock (so
+ * a system suspend does not delay it).
+ *
+ * An optional random jitter is added to each deadline,
+ * so multiple instances do not hit the provider at the
+ * very same second.
+ *
+ * The provider might also tell when its data gets stale
+ * (see weather_info.next_update_in): in that case, the
+ * next update follows its hint instead, within the given
+ * bounds.
+ *
+ * After a failed update, the next one might also be
+ * delayed on purpose (see backoff.c), regardless of
+ * both the interval and the hints.
+ */
+static Sint64 interval_ns;
+static Sint64 jitter_max_ms;
+static Uint32 hint_min_ms;
+static Uint32 hint_max_ms;
+
+/* Last hint received, -1 if already applied. */
+static SDL_AtomicInt hint;
+
+/* Last delay requested, in ms, -1 if already applied. */
+static SDL_AtomicInt delay;
+
+static Uint64 deadline;      /* Monotonic clock, in ns.      */
+static SDL_Time boundary;    /* Last wall-clock boundary.    */
+static SDL_Time wall_deadline;
+
+/**
+ * @brief Returns a random jitter, in nanoseconds.
+ */
+static Sint64 jitter(void)
+{
+	if (!jitter_max_ms)
+		return (0);
+	return (SDL_rand((Sint32)jitter_max_ms + 1) * (Sint64)SDL_NS_PER_MS);
+}
+
+/**
+ * @brief Schedules the next refresh at the next wall-clock
+ * boundary (plus jitter).
+ */
+static void schedule_next(void)
+{
+	SDL_Time now, next;
+	Uint64 mono;
+
+	mono = SDL_GetTicksNS();
+	if (!SDL_GetCurrentTime(&now))
+		now = (SDL_Time)mono;
+
+	/* Wall clock might be slightly behind the monotonic
+	 * one, never schedule the same boundary twice. */
+	next = (now / interval_ns + 1) * interval_ns;
+	if (next <= boundary)
+		next = boundary + interval_ns;
+	boundary = next;
+
+	next += jitter();
+
+	wall_deadline = next;
+	deadline      = mono + (next - now);
+}
+
+/**
+ * @brief Applies the last provider hint, if any: the next
+ * refresh happens after the hinted time (within bounds)
+ * instead of at the next wall-clock boundary.
+ */
+static void apply_hint(void)
+{
+	SDL_Time now;
+	Uint64 mono;
+	Sint64 ms;
+	int h;
+
+	h = SDL_SetAtomicInt(&hint, -1);
+	if (h < 0)
+		return;
+
+	mono = SDL_GetTicksNS();
+
+	if (!h) {
+		log_info("Next update in %" SDL_PRIs64 " s (default interval)\n",
+			(Sint64)(deadline > mono ? (deadline - mono) / SDL_NS_PER_SECOND : 0));
+		return;
+	}
+
+	ms = (Sint64)h * 1000;
+	if (ms < hint_min_ms)
+		ms = hint_min_ms;
+	if (ms > hint_max_ms)
+		ms = hint_max_ms;
+
+	if (!SDL_GetCurrentTime(&now))
+		now = (SDL_Time)mono;
+
+	deadline      = mono + ms * SDL_NS_PER_MS + jitter();
+	wall_deadline = now + (SDL_Time)(deadline - mono);
+
+	log_info("Next update in %" SDL_PRIs64 " s (provider hint: %d s)\n",
+		ms / 1000, h);
+}
+
+/**
+ * @brief Applies the last delay requested, if any: the
+ * next refresh happens after exactly that time.
+ */
+static void apply_delay(void)
+{
+	SDL_Time now;
+	Uint64 mono;
+	int ms;
+
+	ms = SDL_SetAtomicInt(&delay, -1);
+	if (ms < 0)
+		return;
+
+	mono = SDL_GetTicksNS();
+	if (!SDL_GetCurrentTime(&now))
+		now = (SDL_Time)mono;
+
+	deadline      = mono + (Uint64)ms * SDL_NS_PER_MS;
+	wall_deadline = now + (SDL_Time)(deadline - mono);
+
+	log_info("Next update in %d s (backoff)\n", ms / 1000);
+}
+
+/**
+ * @brief Initializes the refresh scheduler.
+ *
+ * @param interval_ms Time between refreshes, in milliseconds.
+ * @param jitter_ms   Maximum random delay added to each
+ *                    refresh, in milliseconds (0 for none).
+ * @param min_ms      Minimum time between refreshes when
+ *                    following provider hints.
+ * @param max_ms      Maximum time between refreshes when
+ *                    following provider hints.
+ */
+void refresh_init(Uint32 interval_ms, Uint32 jitter_ms, Uint32 min_ms,
+	Uint32 max_ms)
+{
+	/* Jitter past the next boundary is pointless. */
+	if (jitter_ms >= interval_ms)
+		jitter_ms = interval_ms - 1;
+
+	interval_ns   = (Sint64)interval_ms * SDL_NS_PER_MS;
+	jitter_max_ms = jitter_ms;
+	hint_min_ms   = min_ms;
+	hint_max_ms   = max_ms < min_ms ? min_ms : max_ms;
+	SDL_SetAtomicInt(&hint, -1);
+	SDL_SetAtomicInt(&delay, -1);
+
+	log_info("Updating every %u s, aligned to the clock (jitter: %u ms)\n",
+		interval_ms / 1000, jitter_ms);
+
+	schedule_next();
+}
+
+/**
+ * @brief Returns the time left until the next refresh,
+ * in milliseconds (rounded up), suitable for
+ * SDL_WaitEventTimeout().
+ */
+Sint32 refresh_timeout(void)
+{
+	Uint64 now, ms;
+
+	apply_hint();
+	apply_delay();
+
+	now = SDL_GetTicksNS();
+	if (now >= deadline)
+		return (0);
+
+	ms = (deadline - now + SDL_NS_PER_MS - 1) / SDL_NS_PER_MS;
+	if (ms > (Uint64)SDL_MAX_SINT32)
+		ms = SDL_MAX_SINT32;
+	return ((Sint32)ms);
+}
+
+/**
+ * @brief Checks if a refresh is due and, if so, schedules
+ * the next one.
+ *
+ * @return Returns 1 if a refresh is due, 0 otherwise.
+ */
+int refresh_due(void)
+{
+	SDL_Time now;
+
+	apply_hint();
+	apply_delay();
+
+	if (SDL_GetTicksNS() < deadline &&
+		(!SDL_GetCurrentTime(&now) || now < wall_deadline))
+	{
+		return (0);
+	}
+
+	schedule_next();
+	return (1);
+}
+
+/**
+ * @brief Tells the scheduler when the provider expects
+ * its data to change, and wakes the main loop up so it
+ * takes effect.
+ *
+ * This is safe to be called from any thread.
+ *
+ * @param secs Seconds until the next update, or 0 to
+ *             keep the regular interval.
+ */
+void refresh_hint(int secs)
+{
+	SDL_Event event;
+
+	SDL_SetAtomicInt(&hint, secs < 0 ? 0 : secs);
+
+	SDL_zero(event);
+	event.type = SDL_EVENT_USER;
+	SDL_PushEvent(&event);
+}
+
+/**
+ * @brief Delays the next refresh by @p ms milliseconds
+ * from now, overriding both the interval and any hint,
+ * and wakes the main loop up so it takes effect.
+ *
+ * This is safe to be called from any thread.
+ *
+ * @param ms Delay, in milliseconds.
+ */
+void refresh_delay(Uint32 ms)
+{
+	SDL_Event event;
+
+	SDL_SetAtomicInt(&delay, ms > SDL_MAX_SINT32 ? SDL_MAX_SINT32 : (int)ms);
+
+	SDL_zero(event);
+	event.type = SDL_EVENT_USER;
+	SDL_PushEvent(&event);
+}
@@ -24,6 +24,8 @@
 
 import requests
 import json
+import os
+import sys
 
 #
 # Example:
@@ -88,28 +90,72 @@ def format_forecast(forecast_data):
 		forecast.append(data)
 	return forecast
 
-# HTTPS request to get JSON data
-response = requests.get("https://api.open-meteo.com/v1/forecast?"
-	+ "latitude="	+ LATITUDE
-	+ "&longitude=" + LONGITUDE
-	+ "&current_weather=true"
-	+ "&daily=weathercode,temperature_2m_max,temperature_2m_min&timezone=auto&forecast_days=4")
+# Fetch the weather data and convert it to Windy's format
+def fetch_weather():
+	# HTTPS request to get JSON data
+	response = requests.get("https://api.open-meteo.com/v1/forecast?"
+		+ "latitude="	+ LATITUDE
+		+ "&longitude=" + LONGITUDE
+		+ "&current_weather=true"
+		+ "&daily=weathercode,temperature_2m_max,temperature_2m_min&timezone=auto&forecast_days=4")
 
-data = response.json()
+	data = response.json()
 
-# Process data and create the output JSON
-output = {
-	"temperature": data["current_weather"]["temperature"],
-	"condition": get_weather_condition(data["current_weather"]["weathercode"]),
-	"max_temp": data["daily"]["temperature_2m_max"][0],
-	"min_temp": data["daily"]["temperature_2m_min"][0],
-	"location": LOCATION,
-	"provider": PROVIDER,
-	"forecast": format_forecast(data["daily"]),
-}
+	# Process data and create the output JSON
+	return {
+		"temperature": data["current_weather"]["temperature"],
+		"condition": get_weather_condition(data["current_weather"]["weathercode"]),
+		"max_temp": data["daily"]["temperature_2m_max"][0],
+		"min_temp": data["daily"]["temperature_2m_min"][0],
+		"location": LOCATION,
+		"provider": PROVIDER,
+		"forecast": format_forecast(data["daily"]),
+	}
+
+# Hash of an output, as computed by windy: 64-bit FNV-1a
+# of all bytes but whitespaces outside json strings
+def windy_hash(text):
+	h = 0xcbf29ce484222325
+	in_string = False
+	escape = False
+	for b in text.encode():
+		if escape:
+			escape = False
+		elif b == ord('"'):
+			in_string = not in_string
+		elif in_string and b == ord('\\'):
+			escape = True
+		elif not in_string and b in b" \t\r\n":
+			continue
+		h = ((h ^ b) * 0x100000001b3) & 0xffffffffffffffff
+	return "%016x" % h
+
+# If the output is the same windy already has (i.e., its
+# hash is 'prev_hash'), just tell it so
+def unchanged(output_json, prev_hash):
+	return prev_hash and windy_hash(output_json) == prev_hash
+
+#
+# Persistent (co-process) mode, i.e., windy -k:
+# for each line read from stdin (the previous hash),
+# print the weather as a single-line JSON.
+#
+if "--persistent" in sys.argv[1:]:
+	for line in sys.stdin:
+		try:
+			output_json = json.dumps(fetch_weather())
+			if unchanged(output_json, line.strip()):
+				output_json = '{"unchanged": true}'
+		except Exception as e:
+			print("Unable to fetch weather: " + str(e), file=sys.stderr)
+			output_json = "{}"
+		print(output_json, flush=True)
+	sys.exit(0)
 
 # Encode the output JSON with proper formatting
-output_json = json.dumps(output, indent=4)
+output_json = json.dumps(fetch_weather(), indent=4)
+if unchanged(output_json, os.environ.get("WINDY_PREV_HASH")):
+	output_json = '{"unchanged": true}'
 
 # Print the output JSON to stdout
 print(output_json)
@@ -0,0 +1,857 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2026 Davidson Francis <davidsondfgl@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <ctype.h>
+#include <stdio.h>
+#include <string.h>
+#include <SDL3/SDL.h>
+
+#include "blend.h"
+#include "font.h"
+#include "glyph.h"
+#include "image.h"
+#include "scene.h"
+#include "stats.h"
+#include "log.h"
+
+extern SDL_Renderer *renderer;
+extern SDL_Window *window;
+
+/* Loaded fonts. */
+static TTF_Font *font_16pt;
+static TTF_Font *font_18pt;
+static TTF_Font *font_40pt;
+
+/*
+ * Scene graph
+ *
+ * The scene is retained as a flat list of nodes, in
+ * drawing order: background, icon, texts and forecast
+ * icons. A commit only marks as dirty the area of the
+ * nodes whose content or bounds changed.
+ *
+ * The whole scene is kept composed into a target
+ * texture: redraws (e.g., due to window events) just
+ * present it, and only the dirty area is composed again.
+ *
+ * Without a renderer (CPU compositor), the window surface
+ * itself plays the role of the scene texture: the dirty
+ * area is blended there, and only that area is pushed to
+ * the screen.
+ */
+enum scene_node_id
+{
+	NODE_BG,
+	NODE_BG_ICON,
+	NODE_TXT,
+	NODE_FC_DAY1 = NODE_TXT + TXT_COUNT,
+	NODE_COUNT   = NODE_FC_DAY1 + 3
+};
+
+static struct scene_node
+{
+	const struct image *img; /* Image, or &txt for texts. */
+	struct image txt;
+	struct glyph_run run;
+	SDL_Point pos;
+	SDL_Rect bounds;         /* Screen area, as composed. */
+	Uint64 key;              /* Content fingerprint.      */
+} nodes[NODE_COUNT];
+
+static SDL_Texture *composed;
+static SDL_Surface *surface;
+static SDL_Rect screen;
+static SDL_Rect dirty;
+
+/* Last rasterized text of each slot, only touched by
+ * the worker thread. */
+static struct text_cache
+{
+	TTF_Font *font;
+	SDL_Color color;
+	char text[WEATHER_STR_SIZE];
+	SDL_Surface *s;
+} txt_cache[TXT_COUNT];
+
+/* Text colors. */
+static SDL_Color color_blue  = {148,199,228,SDL_ALPHA_OPAQUE};
+static SDL_Color color_white = {255,255,255,SDL_ALPHA_OPAQUE};
+static SDL_Color color_gray  = {146,148,149,SDL_ALPHA_OPAQUE};
+static SDL_Color color_cloudy_gray = {162,179,189,SDL_ALPHA_OPAQUE};
+static SDL_Color color_black = {0,0,0,SDL_ALPHA_OPAQUE};
+
+/* Footer text, i.e., where the weather data
+ * were obtained. */
+#define FOOTER_X  21
+#define FOOTER_Y 222
+#define FOOTER_MAX_WIDTH 292
+
+/* Forecast days. */
+#define DAY_Y    151 /* Y-axis for the days text.   */
+#define DAY1_X    16 /* Day 1 text forecast X-axis. */
+#define DAY2_X   116 /* Day 2 text forecast X-axis. */
+#define DAY3_X   230 /* Day 3 text forecast X-axis. */
+#define DAYMAX_Y 171 /* Day max 1-2-3 text Y-axis.  */
+#define DAYMIN_Y 189 /* Day min 1-2-3 text Y-axis.  */
+
+#define DAY_IMG_Y  165 /* Forecast images Y-axis.   */
+#define DAY1_IMG_X  45 /* Forecast day1 img X-axis. */
+#define DAY2_IMG_X 146 /* Forecast day1 img X-axis. */
+#define DAY3_IMG_X 257 /* Forecast day1 img X-axis. */
+
+/*
+ * Header values
+ *
+ * Max X value to the header text,
+ * which includes:
+ * - Current temperature
+ * - Weather condition
+ * - Min/max temperature
+ * - Location
+ *
+ * X value is dynamically calculated
+ */
+#define HDR_MAX_X    310
+
+/* Header Y-values. */
+#define HDR_TEMP_Y    15
+#define HDR_COND_Y    60
+#define HDR_MINMAX_Y  83
+#define HDR_LOC_Y    120
+#define HDR_MAX_WIDTH FOOTER_MAX_WIDTH
+
+/*
+ * Text positions, if 'right' is set, the x coordinate
+ * is the right edge of the text, and the left one is
+ * dynamically calculated.
+ */
+static const struct text_pos {
+	int x;
+	int y;
+	int right;
+} txt_pos[TXT_COUNT] = {
+	[TXT_FOOTER]      = {FOOTER_X,  FOOTER_Y,     0},
+	[TXT_DAY1]        = {DAY1_X,    DAY_Y,        0},
+	[TXT_DAY2]        = {DAY2_X,    DAY_Y,        0},
+	[TXT_DAY3]        = {DAY3_X,    DAY_Y,        0},
+	[TXT_DAY1_MAX]    = {DAY1_X,    DAYMAX_Y,     0},
+	[TXT_DAY2_MAX]    = {DAY2_X,    DAYMAX_Y,     0},
+	[TXT_DAY3_MAX]    = {DAY3_X,    DAYMAX_Y,     0},
+	[TXT_DAY1_MIN]    = {DAY1_X,    DAYMIN_Y,     0},
+	[TXT_DAY2_MIN]    = {DAY2_X,    DAYMIN_Y,     0},
+	[TXT_DAY3_MIN]    = {DAY3_X,    DAYMIN_Y,     0},
+	[TXT_CURR_TEMP]   = {HDR_MAX_X, HDR_TEMP_Y,   1},
+	[TXT_CURR_COND]   = {HDR_MAX_X, HDR_COND_Y,   1},
+	[TXT_CURR_MINMAX] = {HDR_MAX_X, HDR_MINMAX_Y, 1},
+	[TXT_LOCATION]    = {HDR_MAX_X, HDR_LOC_Y,    1},
+};
+
+/* Image positions, the background fills the whole window. */
+static const SDL_Point img_pos[IMG_COUNT] = {
+	[IMG_BG]      = {0, 0},
+	[IMG_BG_ICON] = {0, 0},
+	[IMG_FC_DAY1] = {DAY1_IMG_X, DAY_IMG_Y},
+	[IMG_FC_DAY2] = {DAY2_IMG_X, DAY_IMG_Y},
+	[IMG_FC_DAY3] = {DAY3_IMG_X, DAY_IMG_Y},
+};
+
+/**
+ * @brief Load the same font in three diferent sizes
+ * for the GUI texts.
+ */
+static void load_fonts(void)
+{
+	/* Load require fonts and sizes. */
+	font_16pt = font_open("assets/fonts/NotoSans-Regular.ttf", 16);
+	if (!font_16pt)
+		log_panic("Unable to open font with size 16pt!\n");
+	font_18pt = font_open("assets/fonts/NotoSans-Regular.ttf", 18);
+	if (!font_18pt)
+		log_panic("Unable to open font with size 18pt!\n");
+	font_40pt = font_open("assets/fonts/NotoSans-Regular.ttf", 40);
+	if (!font_40pt)
+		log_panic("Unable to open font with size 40pt!\n");
+}
+
+/**
+ * @brief Sets the image @p img of the frame @p f to the
+ * asset @p path, loading it only if not in the atlas yet.
+ *
+ * @param f    Scene frame.
+ * @param img  Image slot.
+ * @param path Asset path.
+ */
+static void set_image(struct scene_frame *f, enum scene_image img,
+	const char *path)
+{
+	SDL_strlcpy(f->img_path[img], path, sizeof(f->img_path[img]));
+	if (!image_cached(path))
+		f->img[img] = image_load_surface(path);
+}
+
+/**
+ * @brief Returns the node of the image slot @p i.
+ */
+static int img_node(int i)
+{
+	if (i < IMG_FC_DAY1)
+		return (NODE_BG + i);
+	return (NODE_FC_DAY1 + (i - IMG_FC_DAY1));
+}
+
+/**
+ * @brief Calculates the screen area covered by the
+ * node @p n, saving into @p r.
+ */
+static void node_bounds(const struct scene_node *n, SDL_Rect *r)
+{
+	SDL_Rect rr;
+
+	SDL_zerop(r);
+	if (n->img && n->img->src.w) {
+		r->x = n->pos.x + n->img->off.x;
+		r->y = n->pos.y + n->img->off.y;
+		r->w = n->img->src.w;
+		r->h = n->img->src.h;
+	}
+
+	if (n->run.len) {
+		rr.x = n->pos.x + n->run.left;
+		rr.y = n->pos.y;
+		rr.w = n->run.width - n->run.left;
+		rr.h = n->run.height;
+		if (SDL_RectEmpty(r))
+			*r = rr;
+		else
+			SDL_GetRectUnion(r, &rr, r);
+	}
+}
+
+/**
+ * @brief Adds the area @p r to the dirty area, i.e., the
+ * area to be composed again.
+ */
+static void mark_dirty(const SDL_Rect *r)
+{
+	if (SDL_RectEmpty(r))
+		return;
+	if (SDL_RectEmpty(&dirty))
+		dirty = *r;
+	else
+		SDL_GetRectUnion(&dirty, r, &dirty);
+}
+
+/**
+ * @brief Updates the bounds and content fingerprint of
+ * the node @p n, marking its area as dirty (both old and
+ * new) if anything changed.
+ *
+ * @param n   Scene node, already with its new content.
+ * @param key New content fingerprint.
+ */
+static void node_update(struct scene_node *n, Uint64 key)
+{
+	SDL_Rect r;
+
+	node_bounds(n, &r);
+	if (key == n->key && SDL_RectsEqual(&r, &n->bounds))
+		return;
+
+	mark_dirty(&n->bounds);
+	mark_dirty(&r);
+	n->bounds = r;
+	n->key    = key;
+}
+
+/**
+ * @brief Draws all nodes that intersect the area @p area
+ * (or all, if NULL) into the current render target, as a
+ * single batch.
+ */
+static void draw_nodes(const SDL_Rect *area)
+{
+	struct scene_node *n;
+	int i;
+
+	image_batch_begin();
+	for (i = 0; i < NODE_COUNT; i++) {
+		n = &nodes[i];
+		if (area && !SDL_HasRectIntersection(&n->bounds, area))
+			continue;
+		image_batch_add(n->img, n->pos.x, n->pos.y);
+		glyph_run_draw(&n->run, n->pos.x, n->pos.y);
+	}
+	image_batch_draw();
+}
+
+/**
+ * @brief Composes the dirty area of the scene again into
+ * the scene texture, if any.
+ */
+static void compose(void)
+{
+	Uint8 r, g, b, a;
+	SDL_FRect fr;
+
+	if (SDL_RectEmpty(&dirty))
+		return;
+
+	SDL_SetRenderTarget(renderer, composed);
+	SDL_SetRenderClipRect(renderer, &dirty);
+
+	/* Clear the dirty area to transparent. */
+	SDL_GetRenderDrawColor(renderer, &r, &g, &b, &a);
+	SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_NONE);
+	SDL_SetRenderDrawColor(renderer, 0, 0, 0, 0);
+	SDL_RectToFRect(&dirty, &fr);
+	SDL_RenderFillRect(renderer, &fr);
+	SDL_SetRenderDrawColor(renderer, r, g, b, a);
+	SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_BLEND);
+
+	draw_nodes(&dirty);
+
+	SDL_SetRenderClipRect(renderer, NULL);
+	SDL_SetRenderTarget(renderer, NULL);
+
+	SDL_zero(dirty);
+	stats_inc(STATS_FRAMES_COMPOSED);
+}
+
+/**
+ * @brief CPU compositor version of compose(): composes
+ * the dirty area (if any) straight into the window
+ * surface, and pushes it to the screen.
+ *
+ * If nothing is dirty, the whole surface is pushed
+ * as is (e.g., the window was exposed).
+ */
+static void compose_cpu(void)
+{
+	SDL_Surface *s;
+	SDL_Rect area;
+
+	s = SDL_GetWindowSurface(window);
+	if (!s)
+		log_err_to(out, "Unable to get window surface: %s\n", SDL_GetError());
+
+	/* New surface (e.g., resized), contents are lost. */
+	if (s != surface || s->w != screen.w || s->h != screen.h) {
+		surface  = s;
+		screen.w = s->w;
+		screen.h = s->h;
+		scene_invalidate();
+	}
+
+	if (!SDL_GetRectIntersection(&dirty, &screen, &area)) {
+		SDL_UpdateWindowSurface(window);
+		goto out;
+	}
+
+	if (SDL_MUSTLOCK(s) && !SDL_LockSurface(s))
+		log_err_to(out, "Unable to lock window surface: %s\n", SDL_GetError());
+
+	blend_clear(s, &area);
+	image_batch_target(s, &area);
+	draw_nodes(&area);
+
+	if (SDL_MUSTLOCK(s))
+		SDL_UnlockSurface(s);
+
+	SDL_UpdateWindowSurfaceRects(window, &area, 1);
+	SDL_zero(dirty);
+	stats_inc(STATS_FRAMES_COMPOSED);
+out:
+	return;
+}
+
+/**
+ * @brief Rasterizes the text @p text into the text slot
+ * @p t of the frame @p f.
+ *
+ * If the slot already had the very same text (and font
+ * and color) on the previous update, the previous surface
+ * is reused instead.
+ *
+ * @param f      Scene frame to be filled.
+ * @param t      Text slot.
+ * @param font   Text font.
+ * @param text   Text to be rasterized.
+ * @param color  Text color.
+ * @param mwidth Maximum text width, see font_create_surface().
+ */
+static void create_text(struct scene_frame *f, enum scene_text t,
+	TTF_Font *font, const char *text, const SDL_Color *color,
+	unsigned mwidth)
+{
+	struct text_cache *c = &txt_cache[t];
+
+	if (!c->s || c->font != font || strcmp(c->text, text) ||
+		memcmp(&c->color, color, sizeof(*color)))
+	{
+		SDL_DestroySurface(c->s);
+		c->s = image_premultiply(
+			font_create_surface(font, text, color, mwidth));
+		c->font  = font;
+		c->color = *color;
+		SDL_strlcpy(c->text, text, sizeof(c->text));
+		stats_inc(STATS_TXT_RASTERIZED);
+	}
+	else
+		stats_inc(STATS_TXT_REUSED);
+
+	f->txt[t] = SDL_DuplicateSurface(c->s);
+	if (!f->txt[t])
+		log_panic("Unable to duplicate text surface!\n");
+}
+
+/**
+ * @brief Lays out the numeric text @p text into the text
+ * slot @p t of the frame @p f, from the glyph atlas.
+ *
+ * If not possible, the text is rasterized instead.
+ *
+ * @param f     Scene frame to be filled.
+ * @param t     Text slot.
+ * @param font  Text font.
+ * @param text  Text, e.g., '-12º'.
+ * @param color Text color.
+ */
+static void create_number(struct scene_frame *f, enum scene_text t,
+	TTF_Font *font, const char *text, const SDL_Color *color)
+{
+	if (!glyph_run_create(&f->run[t], font, color, text))
+		stats_inc(STATS_TXT_GLYPHS);
+	else
+		create_text(f, t, font, text, color, 0);
+}
+
+/**
+ * @brief Create all texts of the GUI into the frame
+ * @p f.
+ *
+ * @param f              Scene frame to be filled.
+ * @param wi             Weather info to be shown.
+ * @param days_color     Color of footer, days and min temp.
+ * @param max_temp_color Color of the max temp color for the
+ *                       forecast days.
+ * @param hdr_color      Header color (curr temp, location...)
+ */
+static void create_texts(
+	struct scene_frame *f,
+	const struct weather_info *wi,
+	const SDL_Color *days_color,
+	const SDL_Color *max_temp_color,
+	const SDL_Color *hdr_color)
+{
+	int d1, d2, d3;
+	char buff1[32] = {0};
+	char buff2[32] = {0};
+	char buff3[32] = {0};
+
+	static const char *const days_of_week[] = {
+		"sunday",
+		"monday",
+		"tuesday",
+		"wednesday",
+		"thursday",
+		"friday",
+		"saturday"
+	};
+
+	weather_get_forecast_days(&d1, &d2, &d3);
+
+	/* Footer. */
+	create_text(f, TXT_FOOTER, font_16pt, wi->provider,
+		days_color, FOOTER_MAX_WIDTH);
+
+	/* Forecast days string. */
+	create_text(f, TXT_DAY1, font_16pt, days_of_week[d1], days_color, 0);
+	create_text(f, TXT_DAY2, font_16pt, days_of_week[d2], days_color, 0);
+	create_text(f, TXT_DAY3, font_16pt, days_of_week[d3], days_color, 0);
+
+	/* Max temperature value. */
+	snprintf(buff1, sizeof buff1, "%dº", wi->forecast[0].max_temp);
+	snprintf(buff2, sizeof buff2, "%dº", wi->forecast[1].max_temp);
+	snprintf(buff3, sizeof buff3, "%dº", wi->forecast[2].max_temp);
+
+	create_number(f, TXT_DAY1_MAX, font_16pt, buff1, max_temp_color);
+	create_number(f, TXT_DAY2_MAX, font_16pt, buff2, max_temp_color);
+	create_number(f, TXT_DAY3_MAX, font_16pt, buff3, max_temp_color);
+
+	/* Min temperature value. */
+	snprintf(buff1, sizeof buff1, "%dº", wi->forecast[0].min_temp);
+	snprintf(buff2, sizeof buff2, "%dº", wi->forecast[1].min_temp);
+	snprintf(buff3, sizeof buff3, "%dº", wi->forecast[2].min_temp);
+
+	create_number(f, TXT_DAY1_MIN, font_16pt, buff1, days_color);
+	create_number(f, TXT_DAY2_MIN, font_16pt, buff2, days_color);
+	create_number(f, TXT_DAY3_MIN, font_16pt, buff3, days_color);
+
+	/* Header: location, max/min, current condition and temperature. */
+	snprintf(buff1, sizeof buff1, "%dº - %dº", wi->max_temp, wi->min_temp);
+	snprintf(buff2, sizeof buff2, "%c%s",
+		toupper(wi->condition[0]), wi->condition+1);
+	snprintf(buff3, sizeof buff3, "%dº", wi->temperature);
+
+	create_text(f, TXT_LOCATION, font_18pt, wi->location,
+		hdr_color, HDR_MAX_WIDTH);
+	create_number(f, TXT_CURR_MINMAX, font_18pt, buff1, hdr_color);
+	create_text(f, TXT_CURR_COND, font_18pt, buff2, hdr_color, 0);
+	create_number(f, TXT_CURR_TEMP, font_40pt, buff3, hdr_color);
+}
+
+/**
+ * @brief Initializes the scene: loads the fonts and the
+ * initial background, shown until the first weather
+ * update arrives.
+ */
+void scene_init(void)
+{
+	int i;
+
+	load_fonts();
+	image_init();
+	glyph_init();
+
+	/* Nodes positions, texts ones are adjusted on commit. */
+	for (i = 0; i < IMG_COUNT; i++)
+		nodes[img_node(i)].pos = img_pos[i];
+	for (i = 0; i < TXT_COUNT; i++) {
+		nodes[NODE_TXT + i].img   = &nodes[NODE_TXT + i].txt;
+		nodes[NODE_TXT + i].pos.y = txt_pos[i].y;
+	}
+
+	nodes[NODE_BG].img = image_acquire("assets/bg_sunny_day.png", NULL);
+	node_bounds(&nodes[NODE_BG], &nodes[NODE_BG].bounds);
+
+	/* Composed scene, the CPU compositor uses the window
+	 * surface instead (see compose_cpu()). */
+	if (!renderer)
+		return;
+
+	screen.x = 0;
+	screen.y = 0;
+	SDL_GetRenderOutputSize(renderer, &screen.w, &screen.h);
+
+	composed = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_ARGB8888,
+		SDL_TEXTUREACCESS_TARGET, screen.w, screen.h);
+	if (!composed)
+		log_info("Unable to create scene texture, drawing directly: %s\n",
+			SDL_GetError());
+	else
+		SDL_SetTextureBlendMode(composed, SDL_BLENDMODE_BLEND_PREMULTIPLIED);
+
+	scene_invalidate();
+}
+
+/**
+ * @brief Free all fonts and textures used.
+ */
+void scene_quit(void)
+{
+	int i;
+
+	/* Free textures. */
+	image_free(&composed);
+	glyph_quit();
+	image_quit();
+
+	for (i = 0; i < TXT_COUNT; i++) {
+		SDL_DestroySurface(txt_cache[i].s);
+		txt_cache[i].s = NULL;
+	}
+
+	/* Close loaded fonts. */
+	font_close(font_16pt);
+	font_close(font_18pt);
+	font_close(font_40pt);
+}
+
+/**
+ * @brief FNV-1a hash of @p len bytes of @p data,
+ * continuing from the hash @p h.
+ */
+static Uint64 fnv1a(Uint64 h, const void *data, size_t len)
+{
+	const Uint8 *p = data;
+	while (len--) {
+		h ^= *p++;
+		h *= 0x100000001b3ULL;
+	}
+	return (h);
+}
+
+/**
+ * @brief Hashes the string @p str (including its NUL
+ * terminator, so consecutive strings do not mix).
+ */
+static Uint64 fnv1a_str(Uint64 h, const char *str)
+{
+	return (fnv1a(h, str, strlen(str) + 1));
+}
+
+/**
+ * @brief Computes a fingerprint of everything a scene
+ * built for the weather info @p wi depends on: the
+ * weather info itself, but also the time of the day,
+ * moon phase and weekday.
+ *
+ * If two fingerprints are the same, the resulting
+ * scenes are the same too, so there is no need to
+ * build (and draw) it again.
+ *
+ * @param wi Weather info.
+ *
+ * @return Returns the fingerprint.
+ */
+Uint64 scene_fingerprint(const struct weather_info *wi)
+{
+	Uint64 h;
+	int d[4];
+	int i;
+
+	weather_get_forecast_days(&d[1], &d[2], &d[3]);
+	d[0] = weather_is_day();
+
+	h = 0xcbf29ce484222325ULL;
+	h = fnv1a(h, d, sizeof(d));
+	h = fnv1a_str(h, weather_get_moon_phase_icon());
+
+	h = fnv1a(h, &wi->temperature, sizeof(wi->temperature));
+	h = fnv1a(h, &wi->max_temp, sizeof(wi->max_temp));
+	h = fnv1a(h, &wi->min_temp, sizeof(wi->min_temp));
+	h = fnv1a_str(h, wi->condition);
+	h = fnv1a_str(h, wi->location);
+	h = fnv1a_str(h, wi->provider);
+
+	for (i = 0; i < 3; i++) {
+		h = fnv1a(h, &wi->forecast[i].max_temp, sizeof(int));
+		h = fnv1a(h, &wi->forecast[i].min_temp, sizeof(int));
+		h = fnv1a_str(h, wi->forecast[i].condition);
+	}
+	return (h);
+}
+
+/**
+ * @brief Builds a new scene frame @p f for the weather
+ * info pointed by @p wi.
+ *
+ * Chooses which background, icons and colors should be
+ * used, load the images (if not in the atlas yet) and
+ * create the texts. This does not touch the renderer,
+ * and is meant to be called from the worker thread.
+ *
+ * @param f  Scene frame to be filled.
+ * @param wi Weather info to be shown.
+ */
+void scene_build(struct scene_frame *f, const struct weather_info *wi)
+{
+	const SDL_Color *cd, *cmt, *chdr;
+	const char *bg_icon_tex_path;
+	const char *wbg;
+	char buff[sizeof("assets/bg_icon_.png") + WEATHER_COND_SIZE] = {0};
+	int i;
+
+	/* Icon to be loaded if not 'clear'. */
+	snprintf(buff,
+		sizeof buff,
+		"assets/bg_icon_%s.png",
+		wi->condition);
+
+	bg_icon_tex_path = buff;
+
+	/* Load background depending of time and weather condition. */
+	if (!weather_is_day()) {
+		wbg = "assets/bg_night.png";
+
+		/*
+		 * Load moon or other weather icons, accordingly
+		 * to the weather condition.
+		 */
+		if (!strcmp(wi->condition, "clear"))
+			bg_icon_tex_path = weather_get_moon_phase_icon();
+
+		cd   = &color_gray;
+		cmt  = &color_white;
+		chdr = &color_white;
+	}
+
+	/* If day. */
+	else {
+		/* If clear. */
+		if (!strcmp(wi->condition, "clear")) {
+			bg_icon_tex_path = NULL;
+			wbg  = "assets/bg_sunny_day.png";
+			cd   = &color_blue;
+			cmt  = &color_white;
+			chdr = &color_black;
+		}
+
+		/* Anything else, should load bg and icon. */
+		else {
+			wbg  = "assets/bg_notclear_day.png";
+			cd   = &color_cloudy_gray;
+			cmt  = &color_white;
+			chdr = &color_black;
+		}
+	}
+
+	set_image(f, IMG_BG, wbg);
+	if (bg_icon_tex_path)
+		set_image(f, IMG_BG_ICON, bg_icon_tex_path);
+
+	create_texts(f, wi, cd, cmt, chdr);
+
+	/* Forecast days icons. */
+	for (i = 0; i < 3; i++) {
+		snprintf(buff, sizeof buff, "assets/%s.png",
+			wi->forecast[i].condition);
+		set_image(f, IMG_FC_DAY1 + i, buff);
+	}
+}
+
+/**
+ * @brief Fingerprints the text of the frame slot made of
+ * the surface @p s and the glyph run @p r.
+ */
+static Uint64 text_key(const SDL_Surface *s, const struct glyph_run *r)
+{
+	Uint64 h;
+	int y;
+
+	h = fnv1a(0xcbf29ce484222325ULL, r, sizeof(*r));
+	if (!s)
+		return (h);
+
+	h = fnv1a(h, &s->w, sizeof(s->w));
+	h = fnv1a(h, &s->h, sizeof(s->h));
+	for (y = 0; y < s->h; y++)
+		h = fnv1a(h, (const Uint8 *)s->pixels + y * s->pitch, s->w * 4);
+	return (h);
+}
+
+/**
+ * @brief Uploads all surfaces of the frame @p f into the
+ * texture atlas, replacing what is on screen, and then
+ * releases the frame surfaces.
+ *
+ * Images already in the atlas (i.e., used by previous
+ * frames) are not uploaded again, while texts always
+ * replace the previous ones. Only the nodes that actually
+ * changed are marked as dirty.
+ *
+ * Must be called from the thread that owns the renderer.
+ *
+ * @param f Scene frame to be committed.
+ */
+void scene_commit(struct scene_frame *f)
+{
+	struct scene_node *n;
+	int i;
+
+	for (i = 0; i < IMG_COUNT; i++) {
+		n = &nodes[img_node(i)];
+		n->img = NULL;
+		if (f->img_path[i][0])
+			n->img = image_acquire(f->img_path[i], f->img[i]);
+		node_update(n, (Uint64)(uintptr_t)n->img);
+	}
+
+	glyph_commit();
+	image_text_reset();
+	for (i = 0; i < TXT_COUNT; i++) {
+		n = &nodes[NODE_TXT + i];
+		if (!f->txt[i])
+			memset(&n->txt, 0, sizeof(n->txt));
+		else if (image_text_upload(&n->txt, f->txt[i]) < 0)
+			log_info("Not enough room in the atlas for text %d!\n", i);
+
+		n->run   = f->run[i];
+		n->pos.x = txt_pos[i].x;
+		if (txt_pos[i].right)
+			n->pos.x -= n->txt.src.w + n->run.width;
+
+		node_update(n, text_key(f->txt[i], &f->run[i]));
+	}
+
+	scene_frame_free(f);
+}
+
+/**
+ * @brief Releases all surfaces held by the frame @p f.
+ *
+ * @param f Scene frame to be released.
+ */
+void scene_frame_free(struct scene_frame *f)
+{
+	int i;
+
+	for (i = 0; i < IMG_COUNT; i++) {
+		SDL_DestroySurface(f->img[i]);
+		f->img[i] = NULL;
+		f->img_path[i][0] = '\0';
+	}
+	for (i = 0; i < TXT_COUNT; i++) {
+		SDL_DestroySurface(f->txt[i]);
+		f->txt[i] = NULL;
+		memset(&f->run[i], 0, sizeof(f->run[i]));
+	}
+}
+
+/**
+ * @brief Marks the whole scene as dirty, e.g., if the
+ * scene texture contents were lost.
+ */
+void scene_invalidate(void)
+{
+	dirty = screen;
+}
+
+/**
+ * @brief Draws the current scene into the renderer
+ * and presents it.
+ *
+ * Only the dirty area (if any) is composed again, the
+ * rest is already in the scene texture.
+ */
+void scene_render(void)
+{
+	stats_inc(STATS_FRAMES_RENDERED);
+
+	if (!renderer) {
+		compose_cpu();
+		return;
+	}
+
+	if (composed)
+		compose();
+
+	SDL_RenderClear(renderer);
+	if (composed)
+		SDL_RenderTexture(renderer, composed, NULL, NULL);
+	else
+		draw_nodes(NULL);
+
+	SDL_RenderPresent(renderer);
+}
@@ -0,0 +1,94 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2026 Davidson Francis <davidsondfgl@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef SCENE_H
+#define SCENE_H
+
+	#include <SDL3/SDL.h>
+	#include "glyph.h"
+	#include "image.h"
+	#include "weather.h"
+
+	/* Texts shown on screen. */
+	enum scene_text
+	{
+		TXT_FOOTER,
+		TXT_DAY1,
+		TXT_DAY2,
+		TXT_DAY3,
+		TXT_DAY1_MAX,
+		TXT_DAY2_MAX,
+		TXT_DAY3_MAX,
+		TXT_DAY1_MIN,
+		TXT_DAY2_MIN,
+		TXT_DAY3_MIN,
+		TXT_CURR_TEMP,
+		TXT_CURR_COND,
+		TXT_CURR_MINMAX,
+		TXT_LOCATION,
+		TXT_COUNT
+	};
+
+	/* Images shown on screen. */
+	enum scene_image
+	{
+		IMG_BG,
+		IMG_BG_ICON,
+		IMG_FC_DAY1,
+		IMG_FC_DAY2,
+		IMG_FC_DAY3,
+		IMG_COUNT
+	};
+
+	/*
+	 * A scene frame holds everything that a weather update
+	 * needs to show, already decoded and rasterized into
+	 * surfaces, so the thread that owns the renderer only
+	 * needs to upload them.
+	 *
+	 * Images are identified by their asset path (an empty
+	 * path means 'nothing to show' at that slot), and are
+	 * only loaded if not already in the texture atlas.
+	 *
+	 * Numeric texts are glyph runs instead of surfaces.
+	 */
+	struct scene_frame
+	{
+		char img_path[IMG_COUNT][IMAGE_PATH_MAX];
+		SDL_Surface *img[IMG_COUNT];
+		SDL_Surface *txt[TXT_COUNT];
+		struct glyph_run run[TXT_COUNT];
+	};
+
+	extern void scene_init(void);
+	extern void scene_quit(void);
+	extern Uint64 scene_fingerprint(const struct weather_info *wi);
+	extern void scene_build(struct scene_frame *f,
+		const struct weather_info *wi);
+	extern void scene_commit(struct scene_frame *f);
+	extern void scene_frame_free(struct scene_frame *f);
+	extern void scene_invalidate(void);
+	extern void scene_render(void);
+
+#endif /* SCENE_H */
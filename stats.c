@@ -0,0 +1,167 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2026 Davidson Francis <davidsondfgl@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <SDL3/SDL.h>
+
+#include "stats.h"
+#include "log.h"
+
+/*
+ * Debug counters, updated by both the main and the
+ * worker threads, and logged in verbose mode.
+ */
+static SDL_Mutex *lock;
+static Sint64 counters[STATS_COUNT];
+
+static const char *const names[STATS_COUNT] = {
+	[STATS_UPDATES]              = "updates",
+	[STATS_UPDATES_UNCHANGED]    = "updates unchanged (skipped)",
+	[STATS_UPDATES_NOT_MODIFIED] = "updates unchanged (by provider)",
+	[STATS_UPDATES_DEFERRED]     = "updates deferred (hidden)",
+	[STATS_UPDATES_PUSHED]       = "updates pushed (socket)",
+	[STATS_UPDATES_SHARED]       = "updates shared (bus)",
+	[STATS_UPDATES_WATCHED]      = "updates from file (watch)",
+	[STATS_PROVIDER_TIMEOUTS]    = "provider timeouts",
+	[STATS_PROVIDER_TOO_LARGE]   = "provider outputs too large",
+	[STATS_PROVIDER_HEDGES]      = "providers started (hedged)",
+	[STATS_PROVIDER_HEDGE_WINS]  = "hedged providers won",
+	[STATS_PROVIDER_FAILURES]    = "provider failures",
+	[STATS_PROVIDER_FAIL_STREAK] = "provider failures in a row",
+	[STATS_BREAKER_OPEN]         = "circuit open (probing only)",
+	[STATS_BREAKER_TRIPS]        = "circuit opened",
+	[STATS_BREAKER_PROBES]       = "circuit probes",
+	[STATS_PROVIDER_USER_US]     = "provider user time (us)",
+	[STATS_PROVIDER_SYS_US]      = "provider sys time (us)",
+	[STATS_PROVIDER_MAXRSS_KB]   = "provider max RSS, last (KiB)",
+	[STATS_IMG_CACHE_HITS]       = "image cache hits",
+	[STATS_IMG_CACHE_MISSES]     = "image cache misses",
+	[STATS_TXT_RASTERIZED]       = "texts rasterized",
+	[STATS_TXT_REUSED]           = "texts reused",
+	[STATS_TXT_GLYPHS]           = "texts from glyphs",
+	[STATS_FRAMES_COMPOSED]      = "frames composed",
+	[STATS_FRAMES_RENDERED]      = "frames rendered",
+	[STATS_WAKEUPS]              = "main loop wakeups",
+	[STATS_EVENTS]               = "events handled",
+};
+
+/**
+ * @brief Returns the percentage of @p a in @p a + @p b.
+ */
+static double pct(Sint64 a, Sint64 b)
+{
+	return ((a + b) ? 100.0 * a / (a + b) : 0.0);
+}
+
+/**
+ * @brief Initializes the stats module.
+ */
+void stats_init(void)
+{
+	lock = SDL_CreateMutex();
+	if (!lock)
+		log_panic("Unable to create stats lock!\n");
+}
+
+/**
+ * @brief Adds @p v to the counter @p c.
+ *
+ * @param c Counter.
+ * @param v Value to be added.
+ */
+void stats_add(enum stats_counter c, Sint64 v)
+{
+	SDL_LockMutex(lock);
+	counters[c] += v;
+	SDL_UnlockMutex(lock);
+}
+
+/**
+ * @brief Sets the counter @p c to @p v.
+ *
+ * @param c Counter.
+ * @param v New value.
+ */
+void stats_set(enum stats_counter c, Sint64 v)
+{
+	SDL_LockMutex(lock);
+	counters[c] = v;
+	SDL_UnlockMutex(lock);
+}
+
+/**
+ * @brief Returns the current value of the counter @p c.
+ *
+ * @param c Counter.
+ */
+Sint64 stats_get(enum stats_counter c)
+{
+	Sint64 v;
+	SDL_LockMutex(lock);
+	v = counters[c];
+	SDL_UnlockMutex(lock);
+	return (v);
+}
+
+/**
+ * @brief Formats all counters, one per line, into @p buf.
+ *
+ * @param buf  Destination buffer.
+ * @param size Buffer size.
+ *
+ * @return Returns the length of the formatted text, which
+ * is truncated if it does not fit in @p size bytes.
+ */
+size_t stats_format(char *buf, size_t size)
+{
+	Sint64 snap[STATS_COUNT];
+	size_t len;
+	int i;
+
+	SDL_LockMutex(lock);
+	SDL_memcpy(snap, counters, sizeof(snap));
+	SDL_UnlockMutex(lock);
+
+	len = 0;
+	for (i = 0; i < STATS_COUNT && len < size; i++)
+		len += SDL_snprintf(buf + len, size - len,
+			"  %-32s %" SDL_PRIs64 "\n", names[i], snap[i]);
+
+	if (len < size)
+		len += SDL_snprintf(buf + len, size - len, "  %-32s %.1f%%\n",
+			"image cache hit rate",
+			pct(snap[STATS_IMG_CACHE_HITS], snap[STATS_IMG_CACHE_MISSES]));
+
+	return (len < size ? len : size - 1);
+}
+
+/**
+ * @brief Logs all counters.
+ */
+void stats_log(void)
+{
+	char buf[STATS_TEXT_SIZE];
+
+	stats_format(buf, sizeof(buf));
+	log_info("Stats:\n%s", buf);
+}
@@ -0,0 +1,76 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2026 Davidson Francis <davidsondfgl@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef STATS_H
+#define STATS_H
+
+	#include <SDL3/SDL.h>
+
+	/* Debug counters. */
+	enum stats_counter
+	{
+		STATS_UPDATES,
+		STATS_UPDATES_UNCHANGED,
+		STATS_UPDATES_NOT_MODIFIED,
+		STATS_UPDATES_DEFERRED,
+		STATS_UPDATES_PUSHED,
+		STATS_UPDATES_SHARED,
+		STATS_UPDATES_WATCHED,
+		STATS_PROVIDER_TIMEOUTS,
+		STATS_PROVIDER_TOO_LARGE,
+		STATS_PROVIDER_HEDGES,
+		STATS_PROVIDER_HEDGE_WINS,
+		STATS_PROVIDER_FAILURES,
+		STATS_PROVIDER_FAIL_STREAK,
+		STATS_BREAKER_OPEN,
+		STATS_BREAKER_TRIPS,
+		STATS_BREAKER_PROBES,
+		STATS_PROVIDER_USER_US,
+		STATS_PROVIDER_SYS_US,
+		STATS_PROVIDER_MAXRSS_KB,
+		STATS_IMG_CACHE_HITS,
+		STATS_IMG_CACHE_MISSES,
+		STATS_TXT_RASTERIZED,
+		STATS_TXT_REUSED,
+		STATS_TXT_GLYPHS,
+		STATS_FRAMES_COMPOSED,
+		STATS_FRAMES_RENDERED,
+		STATS_WAKEUPS,
+		STATS_EVENTS,
+		STATS_COUNT
+	};
+
+	/* Enough for stats_format() with all counters. */
+	#define STATS_TEXT_SIZE 4096
+
+	extern void stats_init(void);
+	extern void stats_add(enum stats_counter c, Sint64 v);
+	extern void stats_set(enum stats_counter c, Sint64 v);
+	extern Sint64 stats_get(enum stats_counter c);
+	extern size_t stats_format(char *buf, size_t size);
+	extern void stats_log(void);
+
+	#define stats_inc(c) stats_add((c), 1)
+
+#endif /* STATS_H */
@@ -0,0 +1,297 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2026 Davidson Francis <davidsondfgl@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*
+ * Json parser benchmark
+ *
+ * Compares the throughput of the streaming weather parser
+ * against the previous cJSON-based one (DOM + one lookup
+ * per field + strdup per string), for the same input.
+ *
+ * Usage: bench_json [json-file] [iterations]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "deps/cJSON/cJSON.h"
+#include "weather.h"
+
+/* Default input: the README example. */
+static const char default_json[] =
+	"{\n"
+	"    \"temperature\": 22,\n"
+	"    \"condition\": \"clear\",\n"
+	"    \"max_temp\": 20,\n"
+	"    \"min_temp\": 15,\n"
+	"    \"location\": \"Tokyo, Japan\",\n"
+	"    \"provider\": \"OpenMeteo\",\n"
+	"    \"forecast\": [\n"
+	"        {\n"
+	"            \"max_temp\": 34,\n"
+	"            \"min_temp\": 27,\n"
+	"            \"condition\": \"rainfall\"\n"
+	"        },\n"
+	"        {\n"
+	"            \"max_temp\": 34,\n"
+	"            \"min_temp\": 27,\n"
+	"            \"condition\": \"clouds\"\n"
+	"        },\n"
+	"        {\n"
+	"            \"max_temp\": 34,\n"
+	"            \"min_temp\": 27,\n"
+	"            \"condition\": \"clouds\"\n"
+	"        }\n"
+	"    ]\n"
+	"}\n";
+
+/* Previous weather info layout. */
+struct cjson_weather_info
+{
+	int temperature;
+	int max_temp;
+	int min_temp;
+	char *condition;
+	char *location;
+	char *provider;
+	struct
+	{
+		int max_temp;
+		int min_temp;
+		char *condition;
+	} forecast[3];
+};
+
+/**
+ * @brief Frees the strings of @p wi.
+ *
+ * @param wi cJSON weather info.
+ */
+static void cjson_weather_free(struct cjson_weather_info *wi)
+{
+	int i;
+	free(wi->location);
+	free(wi->provider);
+	free(wi->condition);
+	for (i = 0; i < 3; i++)
+		free(wi->forecast[i].condition);
+	memset(wi, 0, sizeof(*wi));
+}
+
+static int cjson_get_number(const cJSON *root, const char *item, int *dest)
+{
+	cJSON *number;
+	number = cJSON_GetObjectItemCaseSensitive(root, item);
+	if (!cJSON_IsNumber(number))
+		return (-1);
+	*dest = number->valueint;
+	return (0);
+}
+
+static int cjson_get_string(const cJSON *root, const char *item, char **dest)
+{
+	cJSON *str;
+	str = cJSON_GetObjectItemCaseSensitive(root, item);
+	if (!cJSON_IsString(str) || !str->valuestring)
+		return (-1);
+	*dest = strdup(str->valuestring);
+	return (*dest ? 0 : -1);
+}
+
+/**
+ * @brief The previous (cJSON) weather parser, minus
+ * the logging.
+ *
+ * @param json_str Json string.
+ * @param wi       cJSON weather info.
+ *
+ * @return Returns 0 if success, -1 otherwise.
+ */
+static int cjson_parse_weather(const char *json_str,
+	struct cjson_weather_info *wi)
+{
+	cJSON *weather, *forecast, *day;
+	int i, ret;
+
+	ret = -1;
+	if (!(weather = cJSON_Parse(json_str)))
+		return (-1);
+
+	if (cjson_get_number(weather, "temperature", &wi->temperature) < 0 ||
+		cjson_get_number(weather, "max_temp", &wi->max_temp) < 0 ||
+		cjson_get_number(weather, "min_temp", &wi->min_temp) < 0 ||
+		cjson_get_string(weather, "condition", &wi->condition) < 0 ||
+		cjson_get_string(weather, "provider", &wi->provider) < 0 ||
+		cjson_get_string(weather, "location", &wi->location) < 0)
+	{
+		goto out;
+	}
+
+	forecast = cJSON_GetObjectItemCaseSensitive(weather, "forecast");
+	if (!forecast || !cJSON_IsArray(forecast))
+		goto out;
+
+	i = 0;
+	cJSON_ArrayForEach(day, forecast) {
+		if (i >= 3)
+			break;
+		if (cjson_get_number(day, "max_temp", &wi->forecast[i].max_temp) < 0 ||
+			cjson_get_number(day, "min_temp", &wi->forecast[i].min_temp) < 0 ||
+			cjson_get_string(day, "condition", &wi->forecast[i].condition) < 0)
+		{
+			goto out;
+		}
+		i++;
+	}
+
+	if (i == 3)
+		ret = 0;
+out:
+	cJSON_Delete(weather);
+	return (ret);
+}
+
+/**
+ * @brief Returns the current monotonic time, in seconds.
+ */
+static double now(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (ts.tv_sec + ts.tv_nsec / 1e9);
+}
+
+/**
+ * @brief Reads the whole file @p path.
+ *
+ * @param path File path.
+ * @param len  Output: file length.
+ *
+ * @return Returns a NUL-terminated buffer with the file
+ * contents, or NULL if error.
+ */
+static char *read_file(const char *path, size_t *len)
+{
+	FILE *f;
+	char *buf;
+	long size;
+
+	if (!(f = fopen(path, "rb")))
+		return (NULL);
+
+	fseek(f, 0, SEEK_END);
+	size = ftell(f);
+	fseek(f, 0, SEEK_SET);
+
+	buf = malloc(size + 1);
+	if (!buf || fread(buf, 1, size, f) != (size_t)size) {
+		free(buf);
+		fclose(f);
+		return (NULL);
+	}
+
+	buf[size] = '\0';
+	*len = size;
+	fclose(f);
+	return (buf);
+}
+
+/**
+ * @brief Prints the results for a single parser.
+ *
+ * @param name  Parser name.
+ * @param secs  Elapsed time, in seconds.
+ * @param iters Number of iterations.
+ * @param len   Input length.
+ */
+static void report(const char *name, double secs, long iters, size_t len)
+{
+	printf("%-10s %8.1f ns/doc %9.1f MB/s\n", name,
+		secs * 1e9 / iters, (double)len * iters / secs / 1e6);
+}
+
+int main(int argc, char **argv)
+{
+	struct cjson_weather_info cwi;
+	struct weather_info wi;
+	double t0, t_cjson, t_stream;
+	const char *json;
+	char *file;
+	size_t len;
+	long iters;
+	long i;
+
+	file  = NULL;
+	json  = default_json;
+	len   = sizeof(default_json) - 1;
+	iters = 200000;
+
+	if (argc > 1) {
+		if (!(file = read_file(argv[1], &len))) {
+			fprintf(stderr, "Unable to read %s!\n", argv[1]);
+			return (1);
+		}
+		json = file;
+	}
+	if (argc > 2)
+		iters = atol(argv[2]);
+
+	/* Both should agree on the input. */
+	memset(&cwi, 0, sizeof(cwi));
+	if (cjson_parse_weather(json, &cwi) < 0 || weather_parse(json, len, &wi) < 0) {
+		fprintf(stderr, "Invalid input json!\n");
+		return (1);
+	}
+	if (cwi.temperature != wi.temperature || strcmp(cwi.location, wi.location) ||
+		cwi.forecast[2].max_temp != wi.forecast[2].max_temp ||
+		strcmp(cwi.forecast[2].condition, wi.forecast[2].condition))
+	{
+		fprintf(stderr, "Parsers disagree!\n");
+		return (1);
+	}
+	cjson_weather_free(&cwi);
+
+	printf("input: %zu bytes, %ld iterations\n", len, iters);
+
+	t0 = now();
+	for (i = 0; i < iters; i++) {
+		cjson_parse_weather(json, &cwi);
+		cjson_weather_free(&cwi);
+	}
+	t_cjson = now() - t0;
+
+	t0 = now();
+	for (i = 0; i < iters; i++)
+		weather_parse(json, len, &wi);
+	t_stream = now() - t0;
+
+	report("cJSON", t_cjson, iters, len);
+	report("streaming", t_stream, iters, len);
+	printf("speedup: %.2fx\n", t_cjson / t_stream);
+
+	free(file);
+	return (0);
+}
@@ -0,0 +1,338 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2026 Davidson Francis <davidsondfgl@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*
+ * Asset pack builder
+ *
+ * Decodes all the PNG images given, trims their fully
+ * transparent borders, premultiplies their alpha and
+ * writes them, together with an index and the layout of
+ * the texture atlas, into a single pack file (see pack.h)
+ * to be mapped by windy.
+ *
+ * Usage: mkpack <output.pack> <image.png>...
+ *
+ * Each image is indexed by its path exactly as given,
+ * e.g., 'assets/clear.png'.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "pack.h"
+
+#define STBI_ONLY_PNG
+#define STB_IMAGE_IMPLEMENTATION
+#include "deps/stb_image.h"
+
+#define ALIGN(x) (((x) + PACK_ALIGN - 1) & ~(uint32_t)(PACK_ALIGN - 1))
+
+/* Decoded images, in the same order as the index. */
+static unsigned char **images;
+
+/**
+ * @brief qsort() comparator for asset names.
+ */
+static int cmp_names(const void *a, const void *b)
+{
+	return (strcmp(*(const char *const *)a, *(const char *const *)b));
+}
+
+/* Index being sorted by cmp_height(). */
+static struct pack_entry *sort_idx;
+
+/**
+ * @brief qsort() comparator for entry indexes, tallest
+ * (visible) images first.
+ */
+static int cmp_height(const void *a, const void *b)
+{
+	const struct pack_entry *ea = &sort_idx[*(const int *)a];
+	const struct pack_entry *eb = &sort_idx[*(const int *)b];
+	if (ea->h != eb->h)
+		return (ea->h < eb->h ? 1 : -1);
+	return (*(const int *)a - *(const int *)b);
+}
+
+/**
+ * @brief Finds the smallest rectangle of the RGBA image
+ * @p buff that contains all its non-transparent pixels.
+ *
+ * @param e    Pack entry, with width and height set. The
+ *             rectangle is saved into x, y, w, h.
+ * @param buff Image pixels (RGBA, one byte per channel).
+ */
+static void trim(struct pack_entry *e, const unsigned char *buff)
+{
+	uint32_t x0, y0, x1, y1;
+	uint32_t x, y;
+
+	x0 = e->width;
+	y0 = e->height;
+	x1 = 0;
+	y1 = 0;
+
+	for (y = 0; y < e->height; y++) {
+		for (x = 0; x < e->width; x++) {
+			if (!buff[(y * e->width + x) * 4 + 3])
+				continue;
+			if (x < x0) x0 = x;
+			if (y < y0) y0 = y;
+			if (x >= x1) x1 = x + 1;
+			if (y >= y1) y1 = y + 1;
+		}
+	}
+
+	/* Fully transparent. */
+	if (x1 <= x0 || y1 <= y0)
+		x0 = x1 = y0 = y1 = 0;
+
+	e->x = x0;
+	e->y = y0;
+	e->w = x1 - x0;
+	e->h = y1 - y0;
+}
+
+/**
+ * @brief Places all images into the texture atlas, by
+ * using a simple 'shelf' packing: images are sorted by
+ * height and placed side by side, and a new shelf is
+ * started once the current one is full.
+ *
+ * @param hdr   Pack header, atlas size is saved here.
+ * @param idx   Pack index.
+ * @param count Entries count.
+ *
+ * @return Returns 0 if success, -1 otherwise.
+ */
+static int layout(struct pack_header *hdr, struct pack_entry *idx, int count)
+{
+	uint32_t x, y, shelf_h;
+	int *order;
+	int i;
+
+	order = malloc(count * sizeof(*order));
+	if (!order)
+		return (-1);
+
+	for (i = 0; i < count; i++)
+		order[i] = i;
+
+	sort_idx = idx;
+	qsort(order, count, sizeof(*order), cmp_height);
+
+	x = 0;
+	y = 0;
+	shelf_h = 0;
+
+	for (i = 0; i < count; i++) {
+		struct pack_entry *e = &idx[order[i]];
+
+		if (e->w + PACK_ATLAS_PAD > PACK_ATLAS_WIDTH) {
+			fprintf(stderr, "Image too wide for the atlas: %s!\n", e->name);
+			free(order);
+			return (-1);
+		}
+
+		if (x + e->w + PACK_ATLAS_PAD > PACK_ATLAS_WIDTH) {
+			x = 0;
+			y += shelf_h;
+			shelf_h = 0;
+		}
+
+		e->atlas_x = x;
+		e->atlas_y = y;
+		x += e->w + PACK_ATLAS_PAD;
+		if (e->h + PACK_ATLAS_PAD > shelf_h)
+			shelf_h = e->h + PACK_ATLAS_PAD;
+	}
+
+	hdr->atlas_w = PACK_ATLAS_WIDTH;
+	hdr->atlas_h = y + shelf_h;
+	free(order);
+	return (0);
+}
+
+/**
+ * @brief Writes the visible rectangle of the image @p buff
+ * as premultiplied ARGB8888 pixels into @p f.
+ *
+ * @param f    Output file.
+ * @param e    Pack entry.
+ * @param buff Image pixels (RGBA, one byte per channel).
+ *
+ * @return Returns 0 if success, -1 otherwise.
+ */
+static int write_pixels(FILE *f, const struct pack_entry *e,
+	const unsigned char *buff)
+{
+	const unsigned char *src;
+	uint32_t r, g, b, a;
+	uint32_t *row;
+	uint32_t x, y;
+	int ret;
+
+	if (!e->w)
+		return (0);
+
+	row = malloc(e->pitch);
+	if (!row)
+		return (-1);
+
+	ret = 0;
+	for (y = 0; y < e->h && !ret; y++) {
+		src = buff + ((e->y + y) * e->width + e->x) * 4;
+		for (x = 0; x < e->w; x++, src += 4) {
+			a = src[3];
+			r = (src[0] * a + 127) / 255;
+			g = (src[1] * a + 127) / 255;
+			b = (src[2] * a + 127) / 255;
+			row[x] = (a << 24) | (r << 16) | (g << 8) | b;
+		}
+		if (fwrite(row, 1, e->pitch, f) != e->pitch)
+			ret = -1;
+	}
+
+	free(row);
+	return (ret);
+}
+
+int main(int argc, char **argv)
+{
+	static const char zeros[PACK_ALIGN];
+	struct pack_header hdr;
+	struct pack_entry *idx;
+	uint32_t offset, pad;
+	const char *out;
+	char **names;
+	int w, h, comp;
+	int count;
+	FILE *f;
+	int ret;
+	int i;
+
+	/* Silence 'defined but not used' stb_image warnings. */
+	((void)stbi__addints_valid);
+	((void)stbi__mul2shorts_valid);
+
+	if (argc < 3) {
+		fprintf(stderr, "Usage: %s <output.pack> <image.png>...\n",
+			argv[0]);
+		return (1);
+	}
+
+	ret   = 1;
+	f     = NULL;
+	out   = argv[1];
+	names = argv + 2;
+	count = argc - 2;
+	qsort(names, count, sizeof(*names), cmp_names);
+
+	idx    = calloc(count, sizeof(*idx));
+	images = calloc(count, sizeof(*images));
+	if (!idx || !images) {
+		fprintf(stderr, "Unable to allocate index!\n");
+		goto out;
+	}
+
+	memset(&hdr, 0, sizeof(hdr));
+	memcpy(hdr.magic, PACK_MAGIC, sizeof(hdr.magic));
+	hdr.version = PACK_VERSION;
+	hdr.format  = PACK_FORMAT_ARGB8888_PREMUL;
+	hdr.count   = count;
+
+	/* Decode and trim everything. */
+	offset = ALIGN(sizeof(hdr) + count * sizeof(*idx));
+
+	for (i = 0; i < count; i++) {
+		if (strlen(names[i]) >= PACK_NAME_MAX) {
+			fprintf(stderr, "Asset name too long: %s!\n", names[i]);
+			goto out;
+		}
+
+		images[i] = stbi_load(names[i], &w, &h, &comp, 4);
+		if (!images[i]) {
+			fprintf(stderr, "Unable to load image: %s!\n", names[i]);
+			goto out;
+		}
+
+		strcpy(idx[i].name, names[i]);
+		idx[i].width  = w;
+		idx[i].height = h;
+		trim(&idx[i], images[i]);
+
+		idx[i].pitch  = idx[i].w * 4;
+		idx[i].offset = offset;
+		offset = ALIGN(offset + idx[i].pitch * idx[i].h);
+	}
+
+	if (layout(&hdr, idx, count) < 0)
+		goto out;
+
+	f = fopen(out, "wb");
+	if (!f) {
+		fprintf(stderr, "Unable to open %s!\n", out);
+		goto out;
+	}
+
+	if (fwrite(&hdr, sizeof(hdr), 1, f) != 1 ||
+		fwrite(idx, sizeof(*idx), count, f) != (size_t)count)
+	{
+		goto write_error;
+	}
+
+	offset = sizeof(hdr) + count * sizeof(*idx);
+	for (i = 0; i < count; i++) {
+		pad = idx[i].offset - offset;
+		if (fwrite(zeros, 1, pad, f) != pad ||
+			write_pixels(f, &idx[i], images[i]) < 0)
+		{
+			goto write_error;
+		}
+		offset = idx[i].offset + idx[i].pitch * idx[i].h;
+	}
+
+	if (fclose(f) != 0) {
+		f = NULL;
+		goto write_error;
+	}
+
+	f   = NULL;
+	ret = 0;
+	goto out;
+
+write_error:
+	fprintf(stderr, "Unable to write %s!\n", out);
+out:
+	if (f)
+		fclose(f);
+	if (ret)
+		remove(out);
+	for (i = 0; images && i < count; i++)
+		stbi_image_free(images[i]);
+	free(images);
+	free(idx);
+	return (ret);
+}
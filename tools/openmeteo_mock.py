@@ -0,0 +1,104 @@
+#!/usr/bin/env python
+
+# MIT License
+#
+# Copyright (c) 2026 Davidson Francis <davidsondfgl@gmail.com>
+#
+# Permission is hereby granted, free of charge, to any person obtaining a copy
+# of this software and associated documentation files (the "Software"), to deal
+# in the Software without restriction, including without limitation the rights
+# to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+# copies of the Software, and to permit persons to whom the Software is
+# furnished to do so, subject to the following conditions:
+#
+# The above copyright notice and this permission notice shall be included in all
+# copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+# AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+# OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+# SOFTWARE.
+
+#
+# Mock Open-Meteo server, for the built-in provider (-o),
+# without network access:
+#
+#   $ python tools/openmeteo_mock.py [--port 8080] [--chunked] [--close]
+#   $ WINDY_OPENMETEO_URL=http://127.0.0.1:8080 ./windy -o "35.69,139.69,Tokyo"
+#
+# Answers every /v1/forecast request with the same canned
+# data, over HTTP/1.1 keep-alive connections (unless with
+# --close), and logs each new connection, so that the
+# connection reuse can be checked.
+#
+
+import argparse
+import json
+from http.server import BaseHTTPRequestHandler, ThreadingHTTPServer
+
+ANSWER = {
+	"latitude": 35.7,
+	"longitude": 139.6875,
+	"timezone": "Asia/Tokyo",
+	"current_weather": {
+		"time": "2026-01-01T12:00",
+		"interval": 900,
+		"temperature": 22.4,
+		"windspeed": 7.2,
+		"winddirection": 180,
+		"is_day": 1,
+		"weathercode": 2
+	},
+	"daily": {
+		"time": ["2026-01-01", "2026-01-02", "2026-01-03", "2026-01-04"],
+		"weathercode": [2, 61, 3, 95],
+		"temperature_2m_max": [24.1, 27.9, 25.0, 29.3],
+		"temperature_2m_min": [15.2, 19.4, 18.1, 20.6]
+	}
+}
+
+class Handler(BaseHTTPRequestHandler):
+	protocol_version = "HTTP/1.1"
+	connections = 0
+
+	def setup(self):
+		super().setup()
+		Handler.connections += 1
+		print("New connection #%d from %s" %
+			(Handler.connections, self.client_address[0]), flush=True)
+
+	def do_GET(self):
+		if not self.path.startswith("/v1/forecast?"):
+			self.send_error(404)
+			return
+
+		body = json.dumps(ANSWER).encode()
+		self.send_response(200)
+		self.send_header("Content-Type", "application/json")
+		if args.close:
+			self.send_header("Connection", "close")
+			self.close_connection = True
+
+		if args.chunked:
+			self.send_header("Transfer-Encoding", "chunked")
+			self.end_headers()
+			half = len(body) // 2
+			for chunk in (body[:half], body[half:], b""):
+				self.wfile.write(b"%x\r\n%s\r\n" % (len(chunk), chunk))
+		else:
+			self.send_header("Content-Length", str(len(body)))
+			self.end_headers()
+			self.wfile.write(body)
+
+parser = argparse.ArgumentParser(description="Mock Open-Meteo server")
+parser.add_argument("--port", type=int, default=8080)
+parser.add_argument("--chunked", action="store_true",
+	help="use chunked transfer encoding")
+parser.add_argument("--close", action="store_true",
+	help="close the connection after each answer")
+args = parser.parse_args()
+
+ThreadingHTTPServer(("127.0.0.1", args.port), Handler).serve_forever()
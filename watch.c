@@ -0,0 +1,264 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2026 Davidson Francis <davidsondfgl@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#define _GNU_SOURCE /* pipe2(). */
+#include <errno.h>
+#include <fcntl.h>
+#include <libgen.h>
+#include <limits.h>
+#include <poll.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/inotify.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <SDL3/SDL.h>
+
+#include "watch.h"
+#include "stats.h"
+#include "weather.h"
+#include "worker.h"
+#include "log.h"
+
+/*
+ * The directory is watched, instead of the file itself,
+ * so that a file replaced by rename() (a new inode) is
+ * still seen.
+ */
+#define WATCH_EVENTS (IN_CLOSE_WRITE|IN_MOVED_TO)
+
+static SDL_Thread *thread;
+static char path[PATH_MAX];
+static const char *name;
+static int inotify_fd = -1;
+static int wake_fds[2] = {-1, -1};
+
+/* Last file parsed, to skip spurious events. */
+static struct stat last;
+
+/*
+ * File contents, read (not mapped: a file truncated by
+ * its writer meanwhile would raise SIGBUS) by the watch
+ * thread only. One extra byte to tell if it is too large.
+ */
+static char data[WATCH_MAX_SIZE + 1];
+
+/**
+ * @brief Reads the watched file and, if it changed since
+ * the last time, parses it and shows its weather info.
+ */
+static void load_file(void)
+{
+	struct weather_info wi;
+	struct stat st;
+	size_t len;
+	ssize_t r;
+	int fd;
+
+	fd = open(path, O_RDONLY|O_CLOEXEC);
+	if (fd < 0)
+		log_err_to(out0, "Unable to open %s: %s\n", path, strerror(errno));
+
+	if (fstat(fd, &st) < 0)
+		log_err_to(out1, "Unable to stat %s: %s\n", path, strerror(errno));
+
+	if (st.st_ino == last.st_ino && st.st_dev == last.st_dev &&
+		st.st_size == last.st_size &&
+		st.st_mtim.tv_sec  == last.st_mtim.tv_sec &&
+		st.st_mtim.tv_nsec == last.st_mtim.tv_nsec)
+	{
+		goto out1;
+	}
+
+	/* The file might be still changing: read what there is. */
+	for (len = 0; len < sizeof(data); len += r) {
+		r = read(fd, data + len, sizeof(data) - len);
+		if (r < 0 && errno == EINTR) {
+			r = 0;
+			continue;
+		}
+		if (r < 0)
+			log_err_to(out1, "Unable to read %s: %s\n", path, strerror(errno));
+		if (!r)
+			break;
+	}
+
+	if (!len || len > WATCH_MAX_SIZE)
+		log_err_to(out1, "Invalid %s size (%s)!\n", path,
+			len ? "too large" : "empty");
+
+	last = st;
+
+	/* Same checks as the provider output. */
+	if (weather_parse(data, len, &wi) == 0) {
+		log_info("%s changed, updating...\n", path);
+		stats_inc(STATS_UPDATES_WATCHED);
+		worker_push(&wi);
+	} else
+		log_info("Invalid weather json at %s, ignored!\n", path);
+
+out1:
+	close(fd);
+out0:
+	return;
+}
+
+/**
+ * @brief Watch thread: waits for the file to change,
+ * until woken up by watch_stop().
+ *
+ * @param data Unused.
+ *
+ * @return Always 0.
+ */
+static int watch_thread(void *data)
+{
+	char buf[4096] __attribute__((aligned(__alignof__(struct inotify_event))));
+	const struct inotify_event *ev;
+	struct pollfd pfds[2];
+	int changed;
+	ssize_t r;
+	char *p;
+
+	((void)data);
+
+	load_file();
+
+	pfds[0].fd     = wake_fds[0];
+	pfds[0].events = POLLIN;
+	pfds[1].fd     = inotify_fd;
+	pfds[1].events = POLLIN;
+
+	while (1)
+	{
+		if (poll(pfds, 2, -1) < 0) {
+			if (errno == EINTR)
+				continue;
+			log_err_to(out, "File watch poll failed: %s\n", strerror(errno));
+		}
+
+		if (pfds[0].revents)
+			break;
+
+		r = read(inotify_fd, buf, sizeof(buf));
+		if (r <= 0)
+			continue;
+
+		/* Many events for our file: parse it only once. */
+		changed = 0;
+		for (p = buf; p < buf + r; p += sizeof(*ev) + ev->len) {
+			ev = (const struct inotify_event *)p;
+			if (ev->mask & IN_Q_OVERFLOW)
+				changed = 1;
+			else if (ev->len && !strcmp(ev->name, name))
+				changed = 1;
+		}
+
+		if (changed)
+			load_file();
+	}
+
+out:
+	return (0);
+}
+
+/**
+ * @brief Starts watching the file at @p file.
+ *
+ * Relative paths are relative to the current directory,
+ * so this must be called before changing it. The file
+ * itself does not need to exist yet, but its directory
+ * does.
+ *
+ * @param file File path.
+ */
+void watch_open(const char *file)
+{
+	char dir[PATH_MAX];
+	char *base;
+
+	if (strlen(file) >= sizeof(dir))
+		log_panic("Watched file path too long: %s\n", file);
+
+	strcpy(dir, file);
+	if (!realpath(dirname(dir), path))
+		log_panic("Unable to watch %s: %s\n", file, strerror(errno));
+
+	strcpy(dir, file);
+	base = basename(dir);
+	if (strlen(path) + strlen(base) + 2 > sizeof(path))
+		log_panic("Watched file path too long: %s\n", file);
+
+	strcat(path, "/");
+	name = path + strlen(path);
+	strcat(path, base);
+
+	inotify_fd = inotify_init1(IN_CLOEXEC|IN_NONBLOCK);
+	if (inotify_fd < 0)
+		log_panic("Unable to initialize inotify: %s\n", strerror(errno));
+
+	/* Watch the directory, i.e., path without name. */
+	path[name - path - 1] = '\0';
+	if (inotify_add_watch(inotify_fd, path, WATCH_EVENTS|IN_ONLYDIR) < 0)
+		log_panic("Unable to watch %s: %s\n", path, strerror(errno));
+	path[name - path - 1] = '/';
+
+	if (pipe2(wake_fds, O_CLOEXEC) < 0)
+		log_panic("Unable to create watch pipe: %s\n", strerror(errno));
+
+	log_info("Watching %s for changes\n", path);
+}
+
+/**
+ * @brief Loads the watched file, if it already exists,
+ * and starts following its changes.
+ */
+void watch_start(void)
+{
+	if (inotify_fd < 0)
+		return;
+
+	thread = SDL_CreateThread(watch_thread, "windy-watch", NULL);
+	if (!thread)
+		log_panic("Unable to create watch thread: %s\n", SDL_GetError());
+}
+
+/**
+ * @brief Stops watching the file.
+ */
+void watch_stop(void)
+{
+	if (!thread)
+		return;
+
+	write(wake_fds[1], "", 1);
+	SDL_WaitThread(thread, NULL);
+	thread = NULL;
+
+	close(wake_fds[0]);
+	close(wake_fds[1]);
+	close(inotify_fd);
+	inotify_fd = -1;
+}
@@ -22,25 +22,34 @@
  * SOFTWARE.
  */
 
+#include <limits.h>
 #include <math.h>
+#include <stddef.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <time.h>
 
-#include "deps/cJSON/cJSON.h"
+#include "json.h"
+#include "provider.h"
+#include "stats.h"
 #include "weather.h"
 #include "log.h"
 
 #define LUNAR_CYCLE_CONSTANT 29.53058770576
-#define BUF_CAPACITY 16
 
-/* Append buffer. */
-struct abuf {
-	char *str;
-	size_t len;
-	size_t capacity;
-};
+/* Day time, in hours: from 06:00 to 17:59. */
+#define DAY_START  6
+#define DAY_END   18
+
+/*
+ * Read buffer, for the provider output: big enough for
+ * most answers in a single read(), and only used by the
+ * worker thread, so kept across updates.
+ */
+#define READ_SIZE (64 * 1024)
+static char read_buf[READ_SIZE];
 
 /* Moon phases path. */
 const char* moon_phases[] = {
@@ -51,320 +60,749 @@ const char* moon_phases[] = {
 };
 
 /**
- * Rounds up to the next power of two.
- * @param target Target number to be rounded.
- * @returns The next power of two.
+ * @brief Check if a given weather condition
+ * is valid or not.
+ *
+ * @param condition Weather condition string.
+ *
+ * @return Returns 1 if valid, 0 otherwise.
+ */
+static int is_condition_valid(const char *condition)
+{
+	int ok = 0;
+
+	if (!strcmp(condition, "clear"))
+		ok = 1;
+	else if (!strcmp(condition, "fog"))
+		ok = 1;
+	else if (!strcmp(condition, "clouds"))
+		ok = 1;
+	else if (!strcmp(condition, "showers"))
+		ok = 1;
+	else if (!strcmp(condition, "rainfall"))
+		ok = 1;
+	else if (!strcmp(condition, "thunder"))
+		ok = 1;
+	else if (!strcmp(condition, "snow"))
+		ok = 1;
+
+	if (!ok)
+		log_info("Condition '%s' is invalid, acceptable values are:\n"
+			 "  clear, fog, clouds, showers, rainfall, thunder, snow\n",
+			 condition);
+
+	return (ok);
+}
+
+/*
+ * Weather json schema
+ *
+ * Each field is described by its name, type and where
+ * it should be saved (offset into the weather_info or
+ * forecast structures), so that the parser can fill the
+ * structure in place, as the values arrive.
+ */
+struct weather_field
+{
+	const char *name;
+	enum json_type type;
+	size_t offset;
+	size_t size;
+};
+
+#define NUMBER_FIELD(st, f) \
+	{#f, JSON_NUMBER, offsetof(struct st, f), 0}
+#define STRING_FIELD(st, f) \
+	{#f, JSON_STRING, offsetof(struct st, f), sizeof(((struct st *)0)->f)}
+
+/* Top-level fields. */
+static const struct weather_field weather_fields[] = {
+	NUMBER_FIELD(weather_info, temperature),
+	NUMBER_FIELD(weather_info, max_temp),
+	NUMBER_FIELD(weather_info, min_temp),
+	STRING_FIELD(weather_info, condition),
+	STRING_FIELD(weather_info, provider),
+	STRING_FIELD(weather_info, location),
+};
+
+/* 'forecast' array items fields. */
+static const struct weather_field forecast_fields[] = {
+	NUMBER_FIELD(forecast, max_temp),
+	NUMBER_FIELD(forecast, min_temp),
+	STRING_FIELD(forecast, condition),
+};
+
+#define NUM_FIELDS(f) (sizeof(f) / sizeof((f)[0]))
+
+/* Weather parser state. */
+struct weather_parser
+{
+	struct json_parser jp;
+	struct weather_info *wi;
+	unsigned seen;
+	unsigned fc_seen[3];
+	int fc_array;
+	int fc_count;
+	double next_update_in; /* Optional hints, 0 if absent. */
+	double valid_until;
+	int unchanged;         /* {"unchanged":true}.         */
+};
+
+/**
+ * @brief Converts a json number @p n into an int,
+ * saturating it (just like cJSON's valueint).
+ *
+ * @param n Number to be converted.
+ *
+ * @return Returns the converted number.
  */
-static size_t round_power(size_t target)
+static int number_to_int(double n)
 {
-	target--;
-	target |= target >> 1;
-	target |= target >> 2;
-	target |= target >> 4;
-	target |= target >> 8;
-	target |= target >> 16;
-	target++;
-	return (target);
+	if (n >= INT_MAX)
+		return (INT_MAX);
+	if (n <= (double)INT_MIN)
+		return (INT_MIN);
+	return ((int)n);
 }
 
 /**
- * @brief Initializes the append buffer.
+ * @brief Copies the UTF-8 string @p src, of length @p len,
+ * into @p dst, truncating it (at a codepoint boundary) if
+ * it does not fit in @p size bytes.
  *
- * @param ab Append buffer pointer to be initialized.
+ * @param dst  Destination buffer.
+ * @param size Destination size.
+ * @param src  Source string.
+ * @param len  Source length.
+ */
+static void str_copy(char *dst, size_t size, const char *src, size_t len)
+{
+	if (len >= size) {
+		len = size - 1;
+		while (len && ((unsigned char)src[len] & 0xC0) == 0x80)
+			len--;
+	}
+	memcpy(dst, src, len);
+	dst[len] = '\0';
+}
+
+/**
+ * @brief Looks for @p key in the schema @p fields and, if
+ * found and with the right type, saves the value @p v into
+ * @p base.
  *
- * @return Returns 0 if success, -1 otherwise.
+ * @param fields Schema fields.
+ * @param nf     Amount of fields.
+ * @param key    Json key.
+ * @param v      Json value.
+ * @param base   Structure to be filled.
+ * @param seen   Bitmap of fields already filled.
  */
-static int abuf_alloc(struct abuf *ab)
+static void set_field(const struct weather_field *fields, size_t nf,
+	const char *key, const struct json_value *v, void *base,
+	unsigned *seen)
 {
-	if (!ab)
-		return (-1);
+	size_t i;
+	char *dst;
+
+	for (i = 0; i < nf; i++) {
+		if (strcmp(fields[i].name, key))
+			continue;
+
+		/* Wrong types are reported as missing, later. */
+		if (fields[i].type != v->type)
+			return;
 
-	ab->capacity = BUF_CAPACITY;
-	ab->len = 0;
-	ab->str = calloc(1, BUF_CAPACITY);
-	if (!ab->str)
-		log_oom("Unable to allocate abuf!\n");
+		dst = (char *)base + fields[i].offset;
+		if (v->type == JSON_NUMBER)
+			*(int *)dst = number_to_int(v->number);
+		else
+			str_copy(dst, fields[i].size, v->str, v->len);
+
+		*seen |= 1u << i;
+		return;
+	}
+}
+
+/**
+ * @brief Json value callback: saves the values that
+ * belong to our schema, ignoring everything else.
+ *
+ * @param data Weather parser.
+ * @param jp   Json parser.
+ * @param v    Parsed value.
+ *
+ * @return Always 0.
+ */
+static int weather_value(void *data, const struct json_parser *jp,
+	const struct json_value *v)
+{
+	struct weather_parser *wp;
+	const char *key;
+	int i;
+
+	wp  = data;
+	key = json_path_key(jp, 0);
+	if (!key)
+		return (0);
+
+	/* {"key": value}. */
+	if (jp->depth == 1) {
+		if (!strcmp(key, "forecast"))
+			wp->fc_array = (v->type == JSON_ARRAY);
+		else if (!strcmp(key, "next_update_in")) {
+			if (v->type == JSON_NUMBER)
+				wp->next_update_in = v->number;
+		}
+		else if (!strcmp(key, "valid_until")) {
+			if (v->type == JSON_NUMBER)
+				wp->valid_until = v->number;
+		}
+		else if (!strcmp(key, "unchanged"))
+			wp->unchanged = (v->type == JSON_BOOL && v->boolean);
+		else
+			set_field(weather_fields, NUM_FIELDS(weather_fields), key,
+				v, wp->wi, &wp->seen);
+		return (0);
+	}
+
+	if (!wp->fc_array || strcmp(key, "forecast"))
+		return (0);
+
+	i = json_path_index(jp, 1);
+	if (i < 0)
+		return (0);
+
+	/* {"forecast": [item, ...]}. */
+	if (jp->depth == 2) {
+		if (i + 1 > wp->fc_count)
+			wp->fc_count = i + 1;
+	}
+
+	/* {"forecast": [{"key": value}, ...]}. */
+	else if (jp->depth == 3 && i < 3 && (key = json_path_key(jp, 2)))
+		set_field(forecast_fields, NUM_FIELDS(forecast_fields), key, v,
+			&wp->wi->forecast[i], &wp->fc_seen[i]);
 
 	return (0);
 }
 
 /**
- * @brief Free the append buffer.
+ * @brief Initializes the weather parser @p wp to fill
+ * the weather info pointed by @p wi.
  *
- * @param ab Append buffer pointer.
+ * @param wp Weather parser.
+ * @param wi Weather info to be filled.
  */
-static void abuf_free(struct abuf *ab)
+static void parser_init(struct weather_parser *wp, struct weather_info *wi)
 {
-	if (!ab)
-		return;
+	memset(wp, 0, sizeof(*wp));
+	memset(wi, 0, sizeof(*wi));
+	wp->wi = wi;
+	json_init(&wp->jp, weather_value, wp);
+}
 
-	free(ab->str);
-	ab->capacity = 0;
-	ab->len = 0;
+/**
+ * @brief Returns the time until the next update suggested
+ * by the provider, i.e., the earliest between its optional
+ * 'next_update_in' (seconds) and 'valid_until' (Unix time)
+ * fields, or 0 if none.
+ *
+ * Data already expired suggests an update as soon as
+ * possible.
+ *
+ * @param wp Weather parser.
+ */
+static int freshness_hint(const struct weather_parser *wp)
+{
+	double secs, left;
+
+	secs = 0;
+	if (wp->next_update_in > 0)
+		secs = wp->next_update_in;
+
+	if (wp->valid_until > 0) {
+		left = wp->valid_until - (double)time(NULL);
+		if (left < 1)
+			left = 1;
+		if (!secs || left < secs)
+			secs = left;
+	}
+	return (number_to_int(ceil(secs)));
 }
 
 /**
- * @brief Adds a new buffer @p buf of length @p len into
- * the append buffer @p ab.
+ * @brief Finishes the parsing and checks if all the
+ * required fields were filled and are valid.
  *
- * @param ab  Append buffer.
- * @param buf Buffer to be add.
- * @param len Buffer length.
+ * @param wp Weather parser.
  *
- * @return Returns 0 if success, -1 otherwise.
+ * @return Returns 0 if the weather info is valid, 1 if
+ * the provider reported that nothing changed (only the
+ * freshness hint is filled then), -1 otherwise.
  */
-static int abuf_append(struct abuf *ab, const char *buf, size_t len)
+static int parser_finish(struct weather_parser *wp)
 {
-	size_t size;
-	char *ptr;
+	struct weather_info *wi;
+	size_t j;
+	int i, n;
 
-	if (!ab)
-		return (-1);
+	wi = wp->wi;
 
-	if (!ab->str && abuf_alloc(ab) < 0)
-		return (-1);
+	if (json_finish(&wp->jp) != JSON_DONE)
+		log_err_to(out0, "Error while parsing json (byte %zu): %s!\n",
+			wp->jp.pos, wp->jp.error);
 
-	size = ab->capacity;
+	if (wp->unchanged) {
+		wi->next_update_in = freshness_hint(wp);
+		return (1);
+	}
 
-	/*
-	 * Check if there is enough space to fit the new
-	 * buf + NULL terminator, if not, increase it.
-	 *
-	 * Although this is a generic append buffer, its
-	 * always interesting to keep space for a NUL-
-	 * terminator, just in case it is used for
-	 * strings.
-	 */
-	if (len >= (ab->capacity - ab->len - 1))
-	{
-		size = round_power(ab->len + len + 1);
-		ptr  = realloc(ab->str, size);
-		if (!ptr)
-			log_oom("Unable to increase append buffer!\n");
+	for (j = 0; j < NUM_FIELDS(weather_fields); j++)
+		if (!(wp->seen & (1u << j)))
+			log_err_to(out0, "'%s' value not found and/or is invalid!\n",
+				weather_fields[j].name);
 
-		ab->str = ptr;
-	}
+	if (!wp->fc_array)
+		log_err_to(out0, "'forecast' array not found!\n");
+
+	n = wp->fc_count < 3 ? wp->fc_count : 3;
+	for (i = 0; i < n; i++)
+		for (j = 0; j < NUM_FIELDS(forecast_fields); j++)
+			if (!(wp->fc_seen[i] & (1u << j)))
+				log_err_to(out0, "'%s' value not found and/or is invalid!\n",
+					forecast_fields[j].name);
+
+	/* Check if all fields were filled. */
+	if (n != 3)
+		log_err_to(out0, "'forecast' array have missing items (%d/3)!\n", n);
+
+	/* Validate all weather conditions. */
+	if (!is_condition_valid(wi->condition))
+		goto out0;
+
+	for (i = 0; i < 3; i++)
+		if (!is_condition_valid(wi->forecast[i].condition))
+			goto out0;
 
-	memcpy(ab->str+ab->len, buf, len);
-	ab->len         += len;
-	ab->capacity     = size;
-	ab->str[ab->len] = '\0';
+	wi->next_update_in = freshness_hint(wp);
 	return (0);
+out0:
+	return (-1);
 }
 
 /**
- * @brief Check if a given weather condition
- * is valid or not.
+ * @brief Parses the json in @p buf, of length @p len, into
+ * the structure weather_info pointed by @p wi.
  *
- * @param condition Weather condition string.
+ * This json (and structure) contains all elements to
+ * show into the screen. If anything fails, @p wi is
+ * left untouched.
  *
- * @return Returns 1 if valid, 0 otherwise.
+ * @param buf Json buffer.
+ * @param len Buffer length.
+ * @param wi  Weather info structure to be filled.
+ *
+ * @return Returns 0 if the parsing was succeeded, 1 if
+ * the json reports that nothing changed, -1 if error.
  */
-static int is_condition_valid(const char *condition)
+int weather_parse(const char *buf, size_t len, struct weather_info *wi)
 {
-	int ok = 0;
+	struct weather_parser wp;
+	struct weather_info new_wi;
+	int ret;
 
-	if (!strcmp(condition, "clear"))
-		ok = 1;
-	else if (!strcmp(condition, "fog"))
-		ok = 1;
-	else if (!strcmp(condition, "clouds"))
-		ok = 1;
-	else if (!strcmp(condition, "showers"))
-		ok = 1;
-	else if (!strcmp(condition, "rainfall"))
-		ok = 1;
-	else if (!strcmp(condition, "thunder"))
-		ok = 1;
-	else if (!strcmp(condition, "snow"))
-		ok = 1;
+	parser_init(&wp, &new_wi);
+	json_feed(&wp.jp, buf, len);
+	if ((ret = parser_finish(&wp)) != 0)
+		return (ret);
 
-	if (!ok)
-		log_info("Condition '%s' is invalid, acceptable values are:\n"
-			 "  clear, fog, clouds, showers, rainfall, thunder, snow\n",
-			 condition);
+	*wi = new_wi;
+	return (0);
+}
 
-	return (ok);
+/* hash_answer() state, between calls. */
+#define HASH_IN_STRING (1 << 0)
+#define HASH_ESCAPE    (1 << 1)
+
+/**
+ * @brief Updates the answer hash @p h with @p len bytes
+ * of @p buf.
+ *
+ * The hash is the 64-bit FNV-1a of all bytes but ASCII
+ * whitespaces outside json strings (so that the json
+ * formatting does not matter, but the strings do), and
+ * is what providers get as WINDY_PREV_HASH, as 16
+ * lowercase hex digits.
+ *
+ * @param h     Hash so far.
+ * @param state Where we are in the json (HASH_*), so far,
+ *              0 at the beginning.
+ * @param buf   Next bytes of the answer.
+ * @param len   Amount of bytes.
+ *
+ * @return Returns the updated hash.
+ */
+static uint64_t hash_answer(uint64_t h, int *state, const char *buf,
+	size_t len)
+{
+	size_t i;
+	int s;
+
+	s = *state;
+	for (i = 0; i < len; i++) {
+		if (s & HASH_ESCAPE)
+			s &= ~HASH_ESCAPE;
+		else if (buf[i] == '"')
+			s ^= HASH_IN_STRING;
+		else if ((s & HASH_IN_STRING) && buf[i] == '\\')
+			s |= HASH_ESCAPE;
+		else if (!(s & HASH_IN_STRING) && (buf[i] == ' ' ||
+			buf[i] == '\t' || buf[i] == '\r' || buf[i] == '\n'))
+		{
+			continue;
+		}
+		h ^= (unsigned char)buf[i];
+		h *= 0x100000001b3ULL;
+	}
+	*state = s;
+	return (h);
 }
 
 /**
- * @brief Given a cSON object pointed by @p root, read
- * its @p item as a number and saves into @p dest.
+ * @brief Checks weather info @p wi that did not come from
+ * the json parser (e.g., filled by a plugin or read from
+ * shared memory), as the parser would: strings are
+ * forcibly terminated, and conditions must be valid.
  *
- * @param root JSON root node.
- * @param item Item name to be read.
- * @param dest Destination integer pointer.
+ * @param wi Weather info to be checked.
  *
- * @return Returns 0 if success, -1 otherwise.
+ * @return Returns 0 if valid, -1 otherwise.
+ */
+int weather_check(struct weather_info *wi)
+{
+	int i;
+
+	wi->condition[WEATHER_COND_SIZE - 1] = '\0';
+	wi->location[WEATHER_STR_SIZE - 1]   = '\0';
+	wi->provider[WEATHER_STR_SIZE - 1]   = '\0';
+	for (i = 0; i < 3; i++)
+		wi->forecast[i].condition[WEATHER_COND_SIZE - 1] = '\0';
+
+	if (!is_condition_valid(wi->condition))
+		return (-1);
+	for (i = 0; i < 3; i++)
+		if (!is_condition_valid(wi->forecast[i].condition))
+			return (-1);
+
+	if (wi->next_update_in < 0)
+		wi->next_update_in = 0;
+	return (0);
+}
+
+/**
+ * @brief Asks the provider plugin of @p p for new weather
+ * info.
+ *
+ * The plugin fills a zeroed copy of @p wi, which is then
+ * checked with weather_check(). If anything fails, @p wi
+ * is left untouched.
+ *
+ * @param p  Weather provider, in plugin mode.
+ * @param wi Weather info structure to be filled.
+ *
+ * @return Returns 0 if success, 1 if nothing changed,
+ * -1 otherwise.
  */
-static int json_get_number(
-	const cJSON *root, const char *item, int *dest)
+static int plugin_get(struct provider *p, struct weather_info *wi)
 {
-	cJSON *number;
-	number = cJSON_GetObjectItemCaseSensitive(root, item);
-	if (!cJSON_IsNumber(number))
-		log_err_to(out0, "'%s' value not found and/or is invalid!\n", item);
-	*dest = number->valueint;
+	struct weather_info new_wi;
+	int state;
+	int ret;
+
+	memset(&new_wi, 0, sizeof(new_wi));
+
+	ret = provider_fetch(p, &new_wi);
+	if (ret < 0)
+		log_err_to(out0, "Plugin was unable to get the weather info!\n");
+
+	if (ret == 1) {
+		if (!p->hash[0])
+			log_err_to(out0, "Plugin reported no changes, but there is "
+				"no previous weather info!\n");
+		wi->next_update_in = new_wi.next_update_in;
+		return (1);
+	}
+
+	if (weather_check(&new_wi) < 0)
+		goto out0;
+
+	*wi = new_wi;
+
+	/* Only marks that there is a previous valid answer. */
+	state = 0;
+	provider_set_hash(p, hash_answer(0xcbf29ce484222325ULL, &state,
+		(const char *)&new_wi, sizeof(new_wi)));
 	return (0);
 out0:
 	return (-1);
 }
 
+/* A provider answer, being read and parsed. */
+struct answer
+{
+	struct provider *p;
+	struct weather_parser wp;
+	struct weather_info wi;
+	uint64_t hash;
+	int hash_state;
+	ssize_t r;
+	int running;
+};
+
+/* Provider answers, see weather_get_any(). */
+static struct answer answers[PROVIDER_MAX];
+
 /**
- * @brief Given a cSON object pointed by @p root, read
- * its @p item as a string and saves into @p dest.
+ * @brief Starts a new request to the provider @p p, whose
+ * answer will be parsed into @p a.
  *
- * @param root JSON root node.
- * @param item Item name to be read.
- * @param dest Destination string pointer.
+ * @param a Answer.
+ * @param p Weather provider.
  *
  * @return Returns 0 if success, -1 otherwise.
  */
-static int json_get_string(
-	const cJSON *root, const char *item, char **dest)
+static int answer_begin(struct answer *a, struct provider *p)
 {
-	cJSON *str;
-	str = cJSON_GetObjectItemCaseSensitive(root, item);
-	if (!cJSON_IsString(str) || !str->valuestring)
-		log_err_to(out0, "'%s' value not found and/or is invalid!\n", item);
-	*dest = strdup(str->valuestring);
-	if (!*dest)
-		log_oom("Unable to allocate string\n");
+	a->p          = p;
+	a->hash       = 0xcbf29ce484222325ULL;
+	a->hash_state = 0;
+	a->r          = 0;
+	a->running    = 0;
+	parser_init(&a->wp, &a->wi);
+
+	if (provider_begin(p) < 0)
+		log_err_to(out0, "Unable to execute provider!\n");
+
+	a->running = 1;
 	return (0);
 out0:
 	return (-1);
 }
 
 /**
- * @brief Parses the received json in @p json_str into the
- * structure weather_info pointed by @p wi.
+ * @brief Finishes the answer @p a, already read, i.e.,
+ * checks how the provider did and what it said.
  *
- * This json (and structure) contains all elements to
- * show into the screen.
+ * @param a Answer.
  *
- * @return Returns 0 if the parsing was succeeded, -1 if not.
+ * @return Returns 0 if a new valid weather info was
+ * parsed, 1 if nothing changed, -1 otherwise.
  */
-static int json_parse_weather(const char *json_str,
-	struct weather_info *wi)
+static int answer_finish(struct answer *a)
 {
-	int i;
-	cJSON *day;
-	cJSON *weather;
-	cJSON *forecast;
-	const char *error_ptr;
-
-	if (!(weather = cJSON_Parse(json_str))) {
-		if ((error_ptr = cJSON_GetErrorPtr()))
-			log_err_to(out0, "Error: %s\n", error_ptr);
-		else
-			log_err_to(out0, "Error while parsing json!\n");
-	}
-
-	if (json_get_number(weather, "temperature", &wi->temperature) < 0)
-		goto out0;
-	if (json_get_number(weather, "max_temp",  &wi->max_temp)  < 0)
-		goto out0;
-	if (json_get_number(weather, "min_temp",  &wi->min_temp)  < 0)
-		goto out0;
-	if (json_get_string(weather, "condition", &wi->condition) < 0)
-		goto out0;
-	if (json_get_string(weather, "provider",  &wi->provider)  < 0)
-		goto out0;
-	if (json_get_string(weather, "location",  &wi->location)  < 0)
-		goto out0;
+	struct provider *p = a->p;
+	int end;
 
-	forecast = cJSON_GetObjectItemCaseSensitive(weather, "forecast");
-	if (!forecast || !cJSON_IsArray(forecast))
-		log_err_to(out0, "'forecast' array not found!\n");
+	a->running = 0;
 
-	i = 0;
-	cJSON_ArrayForEach(day, forecast) {
-		if (i >= 3)
-			break;
-		if (json_get_number(day, "max_temp",  &wi->forecast[i].max_temp)  < 0)
-			goto out0;
-		if (json_get_number(day, "min_temp",  &wi->forecast[i].min_temp)  < 0)
-			goto out0;
-		if (json_get_string(day, "condition", &wi->forecast[i].condition) < 0)
-			goto out0;
-		i++;
-	}
+	end = provider_end(p);
+	if (end == 1 && a->r >= 0)
+		goto unchanged;
 
-	/* Check if all fields were filled. */
-	if (i != 3)
-		log_err_to(out0, "'forecast' array have missing items (%d/3)!\n", i);
+	/* Answered, but did not exit in time. */
+	if (end == PROVIDER_ERR_TIMEOUT && a->r >= 0)
+		a->r = PROVIDER_ERR_TIMEOUT;
 
-	/* Validate all weather conditions. */
-	if (!is_condition_valid(wi->condition))
+	if (a->r == PROVIDER_ERR_TIMEOUT) {
+		stats_inc(STATS_PROVIDER_TIMEOUTS);
+		log_err_to(out0, "Provider timed out (%u ms), killed!\n",
+			p->lim.timeout_ms);
+	}
+	if (a->r == PROVIDER_ERR_TOO_LARGE) {
+		stats_inc(STATS_PROVIDER_TOO_LARGE);
+		log_err_to(out0, "Provider output too large (> %zu bytes), killed!\n",
+			p->lim.max_output);
+	}
+	if (a->r < 0)
+		log_err_to(out0, "Unable to read provider output!\n");
+
+	switch (parser_finish(&a->wp)) {
+	case 0:
+		return (0);
+	case 1:
+		goto unchanged;
+	default:
 		goto out0;
+	}
 
-	for (i = 0; i < 3; i++)
-		if (!is_condition_valid(wi->forecast[i].condition))
-			goto out0;
-
-	cJSON_Delete(weather);
-	return (0);
+unchanged:
+	if (!p->hash[0])
+		log_err_to(out0, "Provider reported no changes, but there is "
+			"no previous weather info!\n");
+	return (1);
 out0:
-	weather_free(wi);
-	cJSON_Delete(weather);
 	return (-1);
 }
 
 /**
- * @brief Deallocates the current data saved into the
- * weather_info structure.
+ * @brief Reads (once) and parses whatever the provider of
+ * the answer @p a has output so far.
+ *
+ * @param a Answer.
  *
- * @param wi Weather info structure.
+ * @return Returns 2 if the answer is not over yet, or
+ * the answer_finish() return value otherwise.
  */
-void weather_free(struct weather_info *wi)
+static int answer_read(struct answer *a)
 {
-	if (!wi)
-		return;
-	free(wi->location);
-	free(wi->provider);
-	free(wi->condition);
-	for (int i = 0; i < 3; i++)
-		free(wi->forecast[i].condition);
+	a->r = provider_read(a->p, read_buf, sizeof(read_buf));
+	if (a->r > 0) {
+		a->hash = hash_answer(a->hash, &a->hash_state, read_buf, a->r);
+		if (json_feed(&a->wp.jp, read_buf, a->r) == JSON_MORE)
+			return (2);
+	}
+	return (answer_finish(a));
 }
 
 /**
- * @brief Issues the command provided by the user, reads its
- * stdout and parses its json.
+ * @brief Asks the providers @p ps for a new weather json,
+ * reads their output and parses it.
  *
- * @param command Command to be issued.
- * @param wi      Weather info structure to be filled.
+ * The first provider is asked first and, if it does not
+ * answer within its budget (see provider_budget()), or
+ * fails, the next one is asked as well (i.e., a hedged
+ * request), and so on. The first valid answer wins, and
+ * all the providers still running are killed.
  *
- * @return Returns 0 if success, -1 otherwise.
+ * The output is parsed as it arrives, without being
+ * buffered first. If anything fails, @p wi is left
+ * untouched.
+ *
+ * If the winner reports that nothing changed since its
+ * last valid answer, the json is not checked at all and
+ * @p wi is kept, but its freshness hint.
+ *
+ * @param ps Weather providers, in priority order.
+ * @param n  Amount of providers, up to PROVIDER_MAX.
+ * @param wi Weather info structure to be filled.
+ *
+ * @return Returns 0 if success, 1 if nothing changed,
+ * -1 otherwise.
  */
-int weather_get(const char *command, struct weather_info *wi)
+int weather_get_any(struct provider **ps, int n, struct weather_info *wi)
 {
-	int ret;
-	FILE *f;
-	struct abuf ab;
-	char tmp[256] = {0};
-
+	struct provider *waiting[PROVIDER_MAX];
+	struct answer *ans, *a;
+	int started, running;
+	int map[PROVIDER_MAX];
+	Uint64 next, now;
+	int i, k, ret;
+
+	ans = answers;
+	a   = NULL;
 	ret = -1;
 
-	if (abuf_alloc(&ab) < 0)
-		return (ret);
+	started = 0;
+	running = 0;
+	next    = SDL_GetTicks();
 
-	f = popen(command, "r");
-	if (!f)
-		goto out0;
+	while (1)
+	{
+		now = SDL_GetTicks();
+
+		/* Next provider: out of budget or nobody left. */
+		if (started < n && (now >= next || !running)) {
+			if (started)
+				stats_inc(STATS_PROVIDER_HEDGES);
+			if (!answer_begin(&ans[started], ps[started]))
+				running++;
+			else
+				provider_account(ps[started], 0);
+			next = now + provider_budget(ps[started]);
+			started++;
+			continue;
+		}
+
+		if (!running)
+			break;
 
-	while (fgets(tmp, sizeof(tmp), f))
-		abuf_append(&ab, tmp, strlen(tmp));
+		/* Only one left: just wait for it. */
+		if (running == 1 && started == n) {
+			for (i = 0; !ans[i].running; i++);
+		} else {
+			for (i = 0, k = 0; i < started; i++)
+				if (ans[i].running) {
+					waiting[k] = ans[i].p;
+					map[k++]   = i;
+				}
+			k = provider_wait(waiting, k,
+				started < n ? (int)(next - now) : -1);
+			if (k < 0)
+				continue;
+			i = map[k];
+		}
+
+		if ((ret = answer_read(&ans[i])) == 2)
+			continue;
+
+		running--;
+		provider_account(ans[i].p, ret >= 0);
+		if (ret >= 0) {
+			a = &ans[i];
+			break;
+		}
+	}
 
-	weather_free(wi);
-	if (json_parse_weather(ab.str, wi) < 0)
-		goto out1;
+	/*
+	 * Losers: too slow counts as failed, so that a provider
+	 * that always loses is soon started along with the next
+	 * one, instead of always waiting for its budget.
+	 */
+	for (i = 0; i < started; i++) {
+		if (!ans[i].running)
+			continue;
+		provider_cancel(ans[i].p);
+		provider_account(ans[i].p, 0);
+	}
 
-	ret = 0;
-out1:
-	pclose(f);
-out0:
-	abuf_free(&ab);
-	return (ret);
+	if (!a)
+		return (-1);
+
+	if (n > 1)
+		log_info("Provider #%d answered in %u ms\n", (int)(a - ans) + 1,
+			a->p->lat_last_ms);
+	if (a != ans)
+		stats_inc(STATS_PROVIDER_HEDGE_WINS);
+
+	if (ret == 1) {
+		wi->next_update_in = a->wi.next_update_in;
+		return (1);
+	}
+
+	/* The others no longer know what is being shown. */
+	*wi = a->wi;
+	for (i = 0; i < n; i++)
+		ps[i]->hash[0] = '\0';
+	provider_set_hash(a->p, a->hash);
+	return (0);
+}
+
+/**
+ * @brief Asks the provider @p p for new weather info,
+ * see weather_get_any().
+ *
+ * @param p  Weather provider.
+ * @param wi Weather info structure to be filled.
+ *
+ * @return Returns 0 if success, 1 if nothing changed,
+ * -1 otherwise.
+ */
+int weather_get(struct provider *p, struct weather_info *wi)
+{
+	if (p->plugin)
+		return (plugin_get(p, wi));
+	return (weather_get_any(&p, 1, wi));
 }
 
 /**
@@ -375,10 +813,42 @@ out0:
 int weather_is_day(void)
 {
 	time_t now;
-	struct tm *now_tm;
-	now    = time(NULL);
-	now_tm = localtime(&now);
-	return (now_tm->tm_hour >= 06 && now_tm->tm_hour <= 17);
+	struct tm now_tm;
+	now = time(NULL);
+	localtime_r(&now, &now_tm);
+	return (now_tm.tm_hour >= DAY_START && now_tm.tm_hour < DAY_END);
+}
+
+/**
+ * @brief Returns when the scene changes by itself, i.e.,
+ * the next switch between day and night, or the next
+ * midnight (forecast weekdays), whichever comes first.
+ *
+ * @return Returns the time of the next change.
+ */
+time_t weather_next_change(void)
+{
+	static const int hours[] = {DAY_START, DAY_END, 24};
+	struct tm now_tm, tm;
+	time_t now, t;
+	size_t i;
+
+	now = time(NULL);
+	localtime_r(&now, &now_tm);
+
+	for (i = 0; i < NUM_FIELDS(hours); i++) {
+		tm          = now_tm;
+		tm.tm_hour  = hours[i];
+		tm.tm_min   = 0;
+		tm.tm_sec   = 0;
+		tm.tm_isdst = -1;
+		t = mktime(&tm);
+		if (t > now)
+			return (t);
+	}
+
+	/* Should not happen, but just in case. */
+	return (now + 3600);
 }
 
 /**
@@ -392,12 +862,12 @@ int weather_is_day(void)
 void weather_get_forecast_days(int *d1, int *d2, int *d3)
 {
 	time_t now;
-	struct tm *now_tm;
-	now    = time(NULL);
-	now_tm = localtime(&now);
-	*d1    = (now_tm->tm_wday + 1) % 7;
-	*d2    = (now_tm->tm_wday + 2) % 7;
-	*d3    = (now_tm->tm_wday + 3) % 7;
+	struct tm now_tm;
+	now = time(NULL);
+	localtime_r(&now, &now_tm);
+	*d1 = (now_tm.tm_wday + 1) % 7;
+	*d2 = (now_tm.tm_wday + 2) % 7;
+	*d3 = (now_tm.tm_wday + 3) % 7;
 }
 
 /**
@@ -25,26 +25,48 @@
 #ifndef WEATHER_H
 #define WEATHER_H
 
+	#include <stddef.h>
+	#include <time.h>
+
+	struct provider;
+
+	/* String sizes, including the NUL-terminator. */
+	#define WEATHER_COND_SIZE  16
+	#define WEATHER_STR_SIZE  128
+
+	/*
+	 * Weather info, with a fixed layout (no pointers),
+	 * so it can be filled in place by the parser.
+	 */
 	struct weather_info
 	{
 		int temperature;
 		int max_temp;
 		int min_temp;
-		char *condition;
-		char *location;
-		char *provider;
+		char condition[WEATHER_COND_SIZE];
+		char location[WEATHER_STR_SIZE];
+		char provider[WEATHER_STR_SIZE];
 		struct forecast
 		{
 			int max_temp;
 			int min_temp;
-			char *condition;
+			char condition[WEATHER_COND_SIZE];
 		} forecast[3];
+
+		/* Provider hint: seconds until the next update,
+		 * 0 if none. */
+		int next_update_in;
 	};
 
-	extern void weather_free(struct weather_info *wi);
-	extern int weather_get(const char *command,
+	extern int weather_parse(const char *buf, size_t len,
+		struct weather_info *wi);
+	extern int weather_check(struct weather_info *wi);
+	extern int weather_get(struct provider *p,
+		struct weather_info *wi);
+	extern int weather_get_any(struct provider **ps, int n,
 		struct weather_info *wi);
 	extern int weather_is_day(void);
+	extern time_t weather_next_change(void);
 	extern void weather_get_forecast_days(int *d1, int *d2, int *d3);
 	extern const char *weather_get_moon_phase_icon(void);
 
@@ -0,0 +1,440 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2026 Davidson Francis <davidsondfgl@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <string.h>
+#include <SDL3/SDL.h>
+
+#include "backoff.h"
+#include "bus.h"
+#include "provider.h"
+#include "refresh.h"
+#include "scene.h"
+#include "stats.h"
+#include "weather.h"
+#include "worker.h"
+#include "log.h"
+
+/*
+ * Update pipeline
+ *
+ * Fetching the weather (i.e., running the provider),
+ * parsing its output, loading images and rasterizing
+ * texts might take seconds, so all of this runs in a
+ * separate thread. The main thread is only notified
+ * (via SDL_EVENT_USER) when a new frame is ready, and
+ * then only needs to upload its surfaces.
+ *
+ * Frames are double-buffered: the worker always builds
+ * into the 'back' frame, and once finished, the back
+ * frame becomes the 'ready' one, waiting to be taken by
+ * the main thread.
+ */
+static SDL_Thread *thread;
+static SDL_Mutex *lock;
+static SDL_Condition *cond;
+
+static struct scene_frame frames[2];
+static struct scene_frame *ready;
+static int back;
+
+static int pending;
+static int busy;
+static int quit;
+
+/* Updates are deferred while paused (e.g., the window
+ * is not visible). */
+static int paused;
+static int deferred;
+
+/* Weather providers, none if push only (see control.c). */
+static struct provider *providers[PROVIDER_MAX];
+static int nproviders;
+
+/* Scene rebuild requested, see worker_refresh_scene(). */
+static int rescene;
+
+/* Last weather info pushed, waiting for the worker. */
+static struct weather_info pushed_wi;
+static int pushed;
+
+/* Current weather info, only touched by the worker. */
+static struct weather_info wi;
+
+/* Fingerprint of the last scene built, if any. */
+static Uint64 last_fingerprint;
+static int has_fingerprint;
+
+/**
+ * @brief Publishes the back frame as the ready one and
+ * notifies the main thread.
+ *
+ * If the previous ready frame was not taken yet, it is
+ * stale and is released.
+ */
+static void publish_frame(void)
+{
+	SDL_Event event;
+
+	SDL_LockMutex(lock);
+	if (ready)
+		scene_frame_free(ready);
+	ready = &frames[back];
+	back ^= 1;
+	SDL_UnlockMutex(lock);
+
+	SDL_zero(event);
+	event.type       = SDL_EVENT_USER;
+	event.user.data1 = NULL;
+	SDL_PushEvent(&event);
+}
+
+/**
+ * @brief Builds and publishes a new frame for the current
+ * weather info, unless nothing changed since the last one.
+ */
+static void show_weather_info(void)
+{
+	Uint64 fp;
+
+	fp = scene_fingerprint(&wi);
+	if (has_fingerprint && fp == last_fingerprint) {
+		log_info("Weather info unchanged, nothing to update.\n");
+		stats_inc(STATS_UPDATES_UNCHANGED);
+		return;
+	}
+
+	scene_build(&frames[back], &wi);
+	publish_frame();
+
+	last_fingerprint = fp;
+	has_fingerprint  = 1;
+}
+
+/**
+ * @brief 'Main' weather update routine.
+ *
+ * Executes the command given, read its output in stdout,
+ * parse its json and then build a new frame with the
+ * text/icons that should be loaded into the screen.
+ *
+ * If nothing changed since the last frame (which is
+ * the case for most updates), either as reported by
+ * the provider itself or not, no frame is built at all,
+ * see show_weather_info().
+ *
+ * If it fails, the next update is backed off, see
+ * backoff.c.
+ */
+static void update_weather_info(void)
+{
+	int ret;
+
+	/* Another instance fetches it for us, see bus.h. */
+	if (!bus_lead()) {
+		log_info("Weather info is fetched by another instance.\n");
+		return;
+	}
+
+	stats_inc(STATS_UPDATES);
+
+	/* A probe only needs a single provider. */
+	if (backoff_open()) {
+		log_info("Probing weather provider...\n");
+		stats_inc(STATS_BREAKER_PROBES);
+		ret = weather_get(providers[0], &wi);
+	} else {
+		log_info("Updating weather info...\n");
+		if (nproviders > 1)
+			ret = weather_get_any(providers, nproviders, &wi);
+		else
+			ret = weather_get(providers[0], &wi);
+	}
+
+	if (ret < 0)
+		log_err_to(failed, "Unable to get weather info!\n");
+
+	backoff_succeeded();
+	refresh_hint(wi.next_update_in);
+
+	/*
+	 * Even if nothing changed, the scene might have: it also
+	 * depends on the clock (day/night, weekdays), and the
+	 * fingerprint makes an unchanged rebuild cheap anyway.
+	 */
+	if (ret == 1) {
+		log_info("Provider reports no changes.\n");
+		stats_inc(STATS_UPDATES_NOT_MODIFIED);
+	}
+
+	bus_publish(&wi);
+	show_weather_info();
+	return;
+failed:
+	backoff_failed();
+}
+
+/**
+ * @brief Worker thread main loop: waits for update
+ * requests and process them.
+ *
+ * @param data Unused.
+ *
+ * @return Always 0.
+ */
+static int worker_thread(void *data)
+{
+	int update;
+	int redo;
+	int push;
+	int i;
+
+	((void)data);
+
+	while (1)
+	{
+		SDL_LockMutex(lock);
+		while (!pending && !((pushed || rescene) && !paused) && !quit)
+			SDL_WaitCondition(cond, lock);
+		if (quit) {
+			SDL_UnlockMutex(lock);
+			break;
+		}
+
+		push = pushed && !paused;
+		if (push)
+			wi = pushed_wi;
+
+		redo     = rescene && !paused;
+		update   = pending;
+		pushed  &= !push;
+		rescene &= !redo;
+		pending  = 0;
+		busy     = 1;
+		SDL_UnlockMutex(lock);
+
+		if (push) {
+			log_info("Weather info pushed, updating...\n");
+			show_weather_info();
+		} else if (redo && has_fingerprint) {
+			log_info("Time of day changed, checking scene...\n");
+			show_weather_info();
+		}
+		if (update)
+			update_weather_info();
+
+		SDL_LockMutex(lock);
+		busy = 0;
+		SDL_UnlockMutex(lock);
+	}
+
+	for (i = 0; i < nproviders; i++)
+		provider_quit(providers[i]);
+	return (0);
+}
+
+/**
+ * @brief Starts the worker thread and requests the
+ * first weather update.
+ *
+ * @param ps Weather providers, in priority order (see
+ *           weather_get_any()), owned by the worker from
+ *           now on.
+ * @param n  Amount of providers, up to PROVIDER_MAX, or
+ *           0 if the weather is only pushed (see
+ *           worker_push()).
+ */
+void worker_start(struct provider *ps, int n)
+{
+	for (nproviders = 0; nproviders < n; nproviders++)
+		providers[nproviders] = &ps[nproviders];
+
+	lock = SDL_CreateMutex();
+	cond = SDL_CreateCondition();
+	if (!lock || !cond)
+		log_panic("Unable to create worker sync objects!\n");
+
+	thread = SDL_CreateThread(worker_thread, "windy-worker", NULL);
+	if (!thread)
+		log_panic("Unable to create worker thread: %s\n", SDL_GetError());
+
+	if (nproviders)
+		worker_request_update();
+}
+
+/**
+ * @brief Stops the worker thread.
+ *
+ * If the worker is in the middle of an update (e.g.,
+ * waiting for a slow provider), it is not waited for,
+ * but detached instead.
+ *
+ * @return Returns 0 if the worker was stopped, -1 if
+ * it is still running (detached).
+ */
+int worker_stop(void)
+{
+	int was_busy;
+
+	if (!thread)
+		return (0);
+
+	SDL_LockMutex(lock);
+	quit     = 1;
+	was_busy = busy;
+	SDL_SignalCondition(cond);
+	SDL_UnlockMutex(lock);
+
+	if (was_busy) {
+		SDL_DetachThread(thread);
+		thread = NULL;
+		return (-1);
+	}
+
+	SDL_WaitThread(thread, NULL);
+	thread = NULL;
+
+	scene_frame_free(&frames[0]);
+	scene_frame_free(&frames[1]);
+	SDL_DestroyCondition(cond);
+	SDL_DestroyMutex(lock);
+	return (0);
+}
+
+/**
+ * @brief Requests a new weather update to the worker.
+ *
+ * If the worker is paused, the update is deferred until
+ * it is resumed.
+ *
+ * This is safe to be called from any thread.
+ *
+ * @return Returns 0 if success, -1 if there is no
+ * provider to update from.
+ */
+int worker_request_update(void)
+{
+	if (!nproviders)
+		return (-1);
+
+	SDL_LockMutex(lock);
+	if (paused) {
+		if (!deferred)
+			stats_inc(STATS_UPDATES_DEFERRED);
+		deferred = 1;
+	} else {
+		pending = 1;
+		SDL_SignalCondition(cond);
+	}
+	SDL_UnlockMutex(lock);
+	return (0);
+}
+
+/**
+ * @brief Shows the (already validated) weather info
+ * @p new_wi, as if it came from the provider.
+ *
+ * If the worker is paused, only the last one pushed is
+ * shown, once resumed.
+ *
+ * This is safe to be called from any thread.
+ *
+ * @param new_wi Weather info.
+ */
+void worker_push(const struct weather_info *new_wi)
+{
+	SDL_LockMutex(lock);
+	pushed_wi = *new_wi;
+	pushed    = 1;
+	SDL_SignalCondition(cond);
+	SDL_UnlockMutex(lock);
+}
+
+/**
+ * @brief Rebuilds the scene from the current weather
+ * info, without asking the provider, e.g., once it is
+ * night or a new day (see weather_next_change()).
+ *
+ * If the worker is paused, it is done once resumed.
+ *
+ * This is safe to be called from any thread.
+ */
+void worker_refresh_scene(void)
+{
+	SDL_LockMutex(lock);
+	rescene = 1;
+	SDL_SignalCondition(cond);
+	SDL_UnlockMutex(lock);
+}
+
+/**
+ * @brief Pauses or resumes the weather updates.
+ *
+ * While paused, update requests are not carried out,
+ * but remembered: once resumed, a single update is
+ * done for all of them.
+ *
+ * @param pause 1 to pause, 0 to resume.
+ */
+void worker_pause(int pause)
+{
+	/* A hidden leader would starve all the other instances. */
+	if (pause)
+		bus_resign();
+
+	SDL_LockMutex(lock);
+	paused = pause;
+	if (!paused && deferred) {
+		deferred = 0;
+		pending  = 1;
+	}
+	if (!paused)
+		SDL_SignalCondition(cond);
+	SDL_UnlockMutex(lock);
+}
+
+/**
+ * @brief Takes the ready frame, if any, moving its
+ * surfaces into @p f.
+ *
+ * @param f Destination frame, owned by the caller
+ *          afterwards.
+ *
+ * @return Returns 1 if there was a frame ready, 0
+ * otherwise.
+ */
+int worker_take_frame(struct scene_frame *f)
+{
+	int ret;
+
+	ret = 0;
+	SDL_LockMutex(lock);
+	if (ready) {
+		*f = *ready;
+		memset(ready, 0, sizeof(*ready));
+		ready = NULL;
+		ret   = 1;
+	}
+	SDL_UnlockMutex(lock);
+	return (ret);
+}